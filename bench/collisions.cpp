@@ -0,0 +1,84 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+
+#include "../include/collisions.hpp"
+
+using namespace object;
+
+using box_type = aabb3d<float>;
+using pair_type = drone::collisions::sweep_and_prune<float>::pair_type;
+
+// every pair tested against every other, what sweep_and_prune replaces
+static std::vector<pair_type> brute_force(const std::vector<box_type>& boxes) {
+    std::vector<pair_type> pairs;
+
+    for (std::uint32_t i = 0; i < boxes.size(); i++)
+        for (std::uint32_t j = i + 1; j < boxes.size(); j++)
+            if (boxes[i].check_bounds(boxes[j]))
+                pairs.emplace_back(i, j);
+    return pairs;
+}
+
+// drones drifting through a flat world, overlapping pairs per frame by sweep_and_prune and by brute force,
+// usage: collisions_bench [drones] [world size] [speed]
+int main(int argc, char** argv) {
+    const size_t drones = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    const float world = argc > 2 ? std::strtof(argv[2], nullptr) : 1000;
+    const float speed = argc > 3 ? std::strtof(argv[3], nullptr) : 1;
+    const size_t frames = 20;
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> place(0, world), drift(-speed, speed);
+
+    std::vector<vector3d<float>> positions, velocities;
+    for (size_t i = 0; i < drones; i++) {
+        positions.emplace_back(place(generator), place(generator), place(generator) / 10);
+        velocities.emplace_back(drift(generator), drift(generator), drift(generator));
+    }
+
+    const vector3d<float> half(2, 2, 2);
+    std::vector<box_type> boxes(drones);
+
+    drone::collisions::sweep_and_prune<float> sweep;
+    for (size_t i = 0; i < drones; i++) {
+        boxes[i] = box_type(vector3d<float>(positions[i] - half), vector3d<float>(positions[i] + half));
+        sweep.insert(boxes[i]);
+    }
+    sweep.update_pairs();
+
+    double swept = 0, brute = 0;
+    size_t found = 0, mismatches = 0;
+
+    for (size_t frame = 0; frame < frames; frame++) {
+        for (size_t i = 0; i < drones; i++) {
+            positions[i] += velocities[i];
+            boxes[i] = box_type(vector3d<float>(positions[i] - half), vector3d<float>(positions[i] + half));
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < drones; i++)
+            sweep.update(static_cast<std::uint32_t>(i), boxes[i]);
+        std::vector<pair_type> pairs = sweep.update_pairs();
+        const auto middle = std::chrono::steady_clock::now();
+        const std::vector<pair_type> expected = brute_force(boxes);
+        const auto stop = std::chrono::steady_clock::now();
+
+        swept += std::chrono::duration<double, std::milli>(middle - start).count();
+        brute += std::chrono::duration<double, std::milli>(stop - middle).count();
+
+        for (pair_type& pair : pairs)
+            if (pair.first > pair.second)
+                std::swap(pair.first, pair.second);
+        std::sort(pairs.begin(), pairs.end());
+
+        mismatches += pairs != expected;
+        found += expected.size();
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "drones " << drones << ", " << found / frames << " pairs per frame, " << mismatches << " mismatching frames" << std::endl;
+    std::cout << "sweep and prune " << swept / double(frames) << " ms, brute force " << brute / double(frames) << " ms per frame" << std::endl;
+}
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+
+#include "../include/scenes.hpp"
+
+using namespace object;
+
+// the same flight of drones stepped by parallel_step on 1..N workers, speedup is against one worker,
+// usage: scaling_bench [max workers] [drones]
+static std::vector<double> fly(size_t workers, size_t drones, const shared_mesh3d<double>& mesh, double& milliseconds) {
+    drone::scenes::scene<double> scene(10);
+
+    for (size_t k = 0; k < drones; k++) {
+        object3d<double> drone(mesh);
+        drone.translate_relative(vector3d<double>(double(k % 100) * 5, double(k / 100) * 5, 0));
+
+        for (size_t j = 0; j < 3; j++)
+            drone.next_sequence(sequence3d<double>(step3d<double>(1, 0.5 * double(j), 0.1 * double(k % 7), 10, 5 * double(k % 3), 0),
+                                                   40, rotation_interpolation((k + j) % 3)));
+        scene.insert(std::move(drone));
+    }
+
+    drone::workers::worker_pool pool(workers);
+    size_t steps = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    while (drone::scenes::parallel_step(scene, pool))
+        steps++;
+    const auto stop = std::chrono::steady_clock::now();
+
+    milliseconds = std::chrono::duration<double, std::milli>(stop - start).count() / double(steps);
+
+    std::vector<double> state;
+    for (drone::scenes::scene<double>::handle_type handle = 0; handle < scene.capacity(); handle++)
+        for (size_t axis = 0; axis < 3; axis++)
+            state.push_back(scene.object(handle).translation()[axis]);
+    return state;
+}
+
+int main(int argc, char** argv) {
+    const size_t max_workers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+    const size_t drones = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 3000;
+
+    std::vector<vector3d<double>> vertexes;
+    for (size_t i = 0; i < 64; i++)
+        vertexes.emplace_back(double(i % 4), double(i / 4 % 4), double(i / 16));
+    const auto mesh = std::make_shared<const mesh3d<double>>(vertexes);
+
+    double single = 0;
+    const std::vector<double> expected = fly(1, drones, mesh, single);
+
+    // the drones start on a 5 unit grid and have to end spread over it, not piled up where their paths began
+    double lower[3] = {expected[0], expected[1], expected[2]}, upper[3] = {expected[0], expected[1], expected[2]};
+    for (size_t i = 0; i < expected.size(); i++) {
+        lower[i % 3] = std::min(lower[i % 3], expected[i]);
+        upper[i % 3] = std::max(upper[i % 3], expected[i]);
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << drones << " drones end within x " << lower[0] << ".." << upper[0] << ", y " << lower[1] << ".." << upper[1]
+              << ", z " << lower[2] << ".." << upper[2] << std::endl;
+    std::cout << "workers  ms/step  speedup  identical" << std::endl;
+    std::cout << std::setw(7) << 1 << std::setw(9) << single << std::setw(9) << 1.0 << std::setw(11) << 1 << std::endl;
+
+    for (size_t workers = 2; workers <= max_workers; workers++) {
+        double milliseconds = 0;
+        const bool identical = fly(workers, drones, mesh, milliseconds) == expected;
+
+        std::cout << std::setw(7) << workers << std::setw(9) << milliseconds << std::setw(9) << single / milliseconds
+                  << std::setw(11) << identical << std::endl;
+    }
+}
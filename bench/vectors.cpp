@@ -0,0 +1,91 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+
+#include "../inc/object.hpp"
+
+using namespace object;
+
+// every intermediate stored in a vector first, what the operators did before they built expressions
+template <class T>
+static void rotate_eagerly(vector3d<T>& vertex, const vector3d<T>& point, const matrix3d<T>& rotation) {
+    const vector3d<T> offset(vertex - point);
+    const vector3d<T> turned(rotation * offset);
+    vertex = vector3d<T>(turned + point);
+}
+
+template <class F>
+static double milliseconds(F body) {
+    const auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// vector3d::rotate and a dynamic_object3d frame, each against the same work done with eager temporaries,
+// usage: vectors_bench [vertexes] [objects]
+int main(int argc, char** argv) {
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const size_t objects = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+    const size_t rounds = 100, frames = 50, mesh_size = 200;
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> place(-10, 10);
+
+    std::vector<vector3d<float>> lazy, eager;
+    for (size_t i = 0; i < count; i++)
+        lazy.emplace_back(place(generator), place(generator), place(generator));
+    eager = lazy;
+
+    const matrix3d<float> rotation = matrix3d<float>::rotation_degrees(vector3d<float>(1, 2, 3));
+    const vector3d<float> point(1, 2, 3);
+
+    const double rotated = milliseconds([&] {
+        for (size_t round = 0; round < rounds; round++)
+            for (vector3d<float>& vertex : lazy)
+                vertex.rotate(point, rotation);
+    });
+    const double rotated_eagerly = milliseconds([&] {
+        for (size_t round = 0; round < rounds; round++)
+            for (vector3d<float>& vertex : eager)
+                rotate_eagerly(vertex, point, rotation);
+    });
+
+    std::vector<vector3d<float>> mesh;
+    for (size_t i = 0; i < mesh_size; i++)
+        mesh.emplace_back(place(generator), place(generator), place(generator));
+
+    std::vector<dynamic_object3d<float>> drones(objects, dynamic_object3d<float>(mesh));
+    std::vector<std::vector<vector3d<float>>> copies(objects, mesh);
+
+    const step3d<float> step(0.1f, 0.1f, 0.1f, 1, 2, 3);
+    const matrix3d<float> turn = matrix3d<float>::rotation_degrees(step.rotation());
+    float checksum = 0;
+
+    const double updated = milliseconds([&] {
+        for (size_t frame = 0; frame < frames; frame++) {
+            for (dynamic_object3d<float>& drone : drones) {
+                drone.step(step);
+                checksum += drone.vertexes().data(0)[0];
+            }
+        }
+    });
+    const double updated_eagerly = milliseconds([&] {
+        for (size_t frame = 0; frame < frames; frame++) {
+            for (std::vector<vector3d<float>>& copy : copies) {
+                for (vector3d<float>& vertex : copy) {
+                    rotate_eagerly(vertex, point, turn);
+                    vertex = vector3d<float>(vertex + step.translation());
+                }
+                checksum += copy[0][0];
+            }
+        }
+    });
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "rotate " << rotated * 1e6 / double(rounds * count) << " ns, eager " << rotated_eagerly * 1e6 / double(rounds * count)
+              << " ns per vertex" << std::endl;
+    std::cout << "update " << updated / double(frames) << " ms, eager " << updated_eagerly / double(frames) << " ms per frame of "
+              << objects << " x " << mesh_size << " vertexes (" << lazy[0][0] + eager[0][0] + checksum << ")" << std::endl;
+}
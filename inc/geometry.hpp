@@ -2,8 +2,21 @@
 #define ZAD5_GEOMETRY_HPP
 
 #include <iostream>
+#include <vector>
+#include <new>
+#include <iterator>
+#include <type_traits>
+#include <algorithm>
+#include <initializer_list>
+#include <limits>
 #include <cmath>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
 #define TO_RADIANS (M_PI / 180)
 #define TO_DEGREES (180 / M_PI)
 
@@ -18,8 +31,258 @@ namespace geometry {
         return radians * TO_DEGREES;
     }
 
+    // libm sin and cos, each evaluated once per angle
+    struct precise_trig {
+        template <class T>
+        static void sincos(T radians, T& sine, T& cosine);
+    };
+
+    template <class T>
+    void precise_trig::sincos(T radians, T& sine, T& cosine) {
+        sine = std::sin(radians);
+        cosine = std::cos(radians);
+    }
+
+    template <class T>
+    struct fast_trig_coefficients;
+
+    // based on: Moshier, Cephes sinf.c / cosf.c, minimax on [-pi/4, pi/4], lowest degree first
+    template <>
+    struct fast_trig_coefficients<float> {
+        static constexpr float pi_2[3] = {1.5703125f, 4.837512969970703125e-4f, 7.54978995489188216e-8f};
+        static constexpr float sine[3] = {-1.6666654611e-1f, 8.3321608736e-3f, -1.9515295891e-4f};
+        static constexpr float cosine[3] = {4.166664568298827e-2f, -1.388731625493765e-3f, 2.443315711809948e-5f};
+    };
+
+    // based on: Moshier, Cephes sin.c, minimax on [-pi/4, pi/4], lowest degree first
+    template <>
+    struct fast_trig_coefficients<double> {
+        static constexpr double pi_2[3] = {1.57079625129699707031e0, 7.54978941586159635336e-8, 5.39030285815811905290e-15};
+        static constexpr double sine[6] = {-1.66666666666666307295e-1, 8.33333333332211858878e-3, -1.98412698295895385996e-4,
+                                            2.75573136213857245213e-6, -2.50507477628578072866e-8, 1.58962301576546568060e-10};
+        static constexpr double cosine[6] = {4.16666666666665929218e-2, -1.38888888888730564116e-3, 2.48015872888517045348e-5,
+                                            -2.75573141792967388112e-7, 2.08757008419747316778e-9, -1.13585365213876817300e-11};
+    };
+
+    // branch free quadrant reduction and polynomial, so batched loops vectorize,
+    // absolute error for |radians| <= 2^13 within about one ulp of 1: float 1.2e-7, double 2.3e-16
+    struct fast_trig {
+        template <class T>
+        static void sincos(T radians, T& sine, T& cosine);
+    };
+
+    template <class T>
+    inline void fast_trig::sincos(T radians, T& sine, T& cosine) {
+        using coefficients = fast_trig_coefficients<T>;
+        static constexpr size_t degree = std::size(coefficients::sine);
+
+        const T scaled = radians * static_cast<T>(2 / M_PI);
+        const int quadrant = static_cast<int>(scaled + std::copysign(T(0.5), scaled));
+        const T q = static_cast<T>(quadrant);
+
+        const T r = ((radians - q * coefficients::pi_2[0]) - q * coefficients::pi_2[1]) - q * coefficients::pi_2[2];
+        const T z = r * r;
+
+        T s = coefficients::sine[degree - 1], c = coefficients::cosine[degree - 1];
+        for (size_t i = degree - 1; i-- > 0;) {
+            s = s * z + coefficients::sine[i];
+            c = c * z + coefficients::cosine[i];
+        }
+
+        s = r + r * z * s;
+        c = 1 - z / 2 + z * z * c;
+
+        // quadrant selection by exact 0 / 1 weights and +-1 signs rather than branches
+        const T swap = static_cast<T>(quadrant & 1), keep = 1 - swap;
+
+        sine = static_cast<T>(1 - (quadrant & 2)) * (s * keep + c * swap);
+        cosine = static_cast<T>(1 - ((quadrant + 1) & 2)) * (c * keep + s * swap);
+    }
+
+#if defined(ZAD5_FAST_TRIG)
+    using default_trig = fast_trig;
+#else
+    using default_trig = precise_trig;
+#endif
+
+    template <class P = default_trig, class T>
+    static void sincos(const T* radians, T* sines, T* cosines, size_t count) {
+        for (size_t i = 0; i < count; i++)
+            P::sincos(radians[i], sines[i], cosines[i]);
+    }
+
+    // lazy vector arithmetic: operators build expression nodes, scalars are computed once per element
+    // when the node converts into its result type R, so chained expressions run as a single loop
+    template <class E, class T, size_t N, class R>
+    class vector_expression {
+    public:
+        using expression_type = E;
+        using scalar_type = T;
+        using result_type = R;
+
+        static constexpr size_t size = N;
+
+        T operator[](size_t i) const;
+
+        R evaluate() const;
+        operator R() const;
+    };
+
+    template <class E, class T, size_t N, class R>
+    T vector_expression<E, T, N, R>::operator[](size_t i) const {
+        return static_cast<const E&>(*this)[i];
+    }
+
+    template <class E, class T, size_t N, class R>
+    R vector_expression<E, T, N, R>::evaluate() const {
+        R result;
+        for (size_t i = 0; i < N; i++)
+            result[i] = static_cast<const E&>(*this)[i];
+        return result;
+    }
+
+    template <class E, class T, size_t N, class R>
+    vector_expression<E, T, N, R>::operator R() const {
+        return evaluate();
+    }
+
+    template <class T, size_t N, class R>
+    class basic_vector;
+
+    template <class E, class = void>
+    struct is_vector_expression : std::false_type {};
+
+    template <class E>
+    struct is_vector_expression<E, std::void_t<typename E::expression_type>>
+            : std::is_base_of<vector_expression<E, typename E::scalar_type, E::size, typename E::result_type>, E> {};
+
+    // operands are named by how they were passed, vectors passed as lvalues are held by reference,
+    // temporary vectors and intermediate nodes by value, so an expression kept in auto outlives its temporaries
+    template <class E, class V = std::decay_t<E>>
+    using vector_operand = typename std::conditional<
+            std::is_lvalue_reference<E>::value && std::is_base_of<basic_vector<typename V::scalar_type, V::size, V>, V>::value,
+            const V&, const V>::type;
+
+    template <class F, class E1, class E2, class T, size_t N, class R>
+    class vector_binary_expression : public vector_expression<vector_binary_expression<F, E1, E2, T, N, R>, T, N, R> {
+    public:
+        vector_binary_expression(const std::decay_t<E1>& lhs, const std::decay_t<E2>& rhs) noexcept;
+
+        T operator[](size_t i) const;
+
+    private:
+        vector_operand<E1> lhs;
+        vector_operand<E2> rhs;
+    };
+
+    template <class F, class E1, class E2, class T, size_t N, class R>
+    vector_binary_expression<F, E1, E2, T, N, R>::vector_binary_expression(const std::decay_t<E1>& lhs,
+                                                                           const std::decay_t<E2>& rhs) noexcept
+        : lhs(lhs), rhs(rhs) {}
+
+    template <class F, class E1, class E2, class T, size_t N, class R>
+    T vector_binary_expression<F, E1, E2, T, N, R>::operator[](size_t i) const {
+        static constexpr auto operand = F();
+        return operand(lhs[i], rhs[i]);
+    }
+
+    template <class F, class E, class T, size_t N, class R>
+    class vector_scalar_expression : public vector_expression<vector_scalar_expression<F, E, T, N, R>, T, N, R> {
+    public:
+        vector_scalar_expression(const std::decay_t<E>& lhs, T scalar) noexcept;
+
+        T operator[](size_t i) const;
+
+    private:
+        vector_operand<E> lhs;
+        T scalar;
+    };
+
+    template <class F, class E, class T, size_t N, class R>
+    vector_scalar_expression<F, E, T, N, R>::vector_scalar_expression(const std::decay_t<E>& lhs, T scalar) noexcept
+        : lhs(lhs), scalar(scalar) {}
+
+    template <class F, class E, class T, size_t N, class R>
+    T vector_scalar_expression<F, E, T, N, R>::operator[](size_t i) const {
+        static constexpr auto operand = F();
+        return operand(lhs[i], scalar);
+    }
+
+    template <class E1, class E2, class T, size_t N, class R1, class R2>
+    T dot(const vector_expression<E1, T, N, R1>& lhs, const vector_expression<E2, T, N, R2>& rhs) {
+        const E1& l = static_cast<const E1&>(lhs);
+        const E2& r = static_cast<const E2&>(rhs);
+
+        T result = 0;
+        for (size_t i = 0; i < N; i++)
+            result += l[i] * r[i];
+        return result;
+    }
+
+    template <class E1, class E2, class T, size_t N, class R1, class R2>
+    T operator*(const vector_expression<E1, T, N, R1>& lhs, const vector_expression<E2, T, N, R2>& rhs) {
+        return dot(lhs, rhs);
+    }
+
+    // both operands vector expressions of one scalar type and size, the result type is the left one's
+    template <template <class> class F, class E1, class E2, class V1 = std::decay_t<E1>, class V2 = std::decay_t<E2>>
+    using vector_binary_result = typename std::enable_if<
+            is_vector_expression<V1>::value && is_vector_expression<V2>::value &&
+            std::is_same<typename V1::scalar_type, typename V2::scalar_type>::value && V1::size == V2::size,
+            vector_binary_expression<F<typename V1::scalar_type>, E1, E2, typename V1::scalar_type, V1::size, typename V1::result_type>>::type;
+
+    template <template <class> class F, class E, class V = std::decay_t<E>>
+    using vector_scalar_result = typename std::enable_if<
+            is_vector_expression<V>::value,
+            vector_scalar_expression<F<typename V::scalar_type>, E, typename V::scalar_type, V::size, typename V::result_type>>::type;
+
+    template <class E1, class E2>
+    vector_binary_result<std::plus, E1, E2> operator+(E1&& lhs, E2&& rhs) {
+        return {lhs, rhs};
+    }
+
+    template <class E1, class E2>
+    vector_binary_result<std::minus, E1, E2> operator-(E1&& lhs, E2&& rhs) {
+        return {lhs, rhs};
+    }
+
+    template <class E>
+    vector_scalar_result<std::plus, E> operator+(E&& lhs, typename std::decay_t<E>::scalar_type scalar) {
+        return {lhs, scalar};
+    }
+
+    template <class E>
+    vector_scalar_result<std::minus, E> operator-(E&& lhs, typename std::decay_t<E>::scalar_type scalar) {
+        return {lhs, scalar};
+    }
+
+    template <class E>
+    vector_scalar_result<std::multiplies, E> operator*(E&& lhs, typename std::decay_t<E>::scalar_type scalar) {
+        return {lhs, scalar};
+    }
+
+    template <class E>
+    vector_scalar_result<std::divides, E> operator/(E&& lhs, typename std::decay_t<E>::scalar_type scalar) {
+        return {lhs, scalar};
+    }
+
+    template <class E>
+    vector_scalar_result<std::modulus, E> operator%(E&& lhs, typename std::decay_t<E>::scalar_type scalar) {
+        return {lhs, scalar};
+    }
+
+    template <class E, class T, size_t N, class R>
+    std::ostream& operator<<(std::ostream& out, const vector_expression<E, T, N, R>& vector) {
+        for (size_t i = 0; i < N; i++) {
+            out << vector[i];
+            if (i < N - 1)
+                out << " ";
+        }
+        return out;
+    }
+
     template <class T, size_t N, class R>
-    class basic_vector {
+    class basic_vector : public vector_expression<R, T, N, R> {
     public:
         basic_vector() = default;
         explicit basic_vector(const T (&scalars)[N]) noexcept;
@@ -30,26 +293,11 @@ namespace geometry {
         const T& operator[](size_t i) const;
         T& operator[](size_t i);
 
-        template <class _R>
-        T operator*(const basic_vector<T, N, _R>& vector) const;
-
-        template <class _R>
-        R operator+(const basic_vector<T, N, _R>& vector) const;
-
-        template <class _R>
-        R operator-(const basic_vector<T, N, _R>& vector) const;
-
-        template <class _R>
-        R& operator+=(const basic_vector<T, N, _R>& vector);
-
-        template <class _R>
-        R& operator-=(const basic_vector<T, N, _R>& vector);
+        template <class E, class _R>
+        R& operator+=(const vector_expression<E, T, N, _R>& vector);
 
-        R operator+(T scalar) const;
-        R operator-(T scalar) const;
-        R operator*(T scalar) const;
-        R operator/(T scalar) const;
-        R operator%(T scalar) const;
+        template <class E, class _R>
+        R& operator-=(const vector_expression<E, T, N, _R>& vector);
 
         R& operator+=(T scalar);
         R& operator-=(T scalar);
@@ -57,8 +305,8 @@ namespace geometry {
         R& operator/=(T scalar);
         R& operator%=(T scalar);
 
-        template <class _R>
-        bool operator==(const basic_vector<T, N, _R>& vector) const;
+        template <class E, class _R>
+        bool operator==(const vector_expression<E, T, N, _R>& vector) const;
 
         template <class _T, size_t _N, class _R>
         friend std::istream& operator>>(std::istream& in, basic_vector<_T, _N, _R>& vector);
@@ -67,14 +315,8 @@ namespace geometry {
         friend std::ostream& operator<<(std::ostream& out, const basic_vector<_T, _N, _R>& vector);
 
     protected:
-        template <template <class> class F, class _R>
-        R copy_operator_vector(const basic_vector<T, N, _R>& vector) const;
-
-        template <template <class> class F, class _R>
-        R& assign_operator_vector(const basic_vector<T, N, _R>& vector);
-
-        template <template <class> class F>
-        R copy_operator_scalar(T scalar) const;
+        template <template <class> class F, class E, class _R>
+        R& assign_operator_vector(const vector_expression<E, T, N, _R>& vector);
 
         template <template <class> class F>
         R& assign_operator_scalar(T scalar);
@@ -83,37 +325,16 @@ namespace geometry {
     };
 
     template <class T, size_t N, class R>
-    template <template <class> class F, class _R>
-    R basic_vector<T, N, R>::copy_operator_vector(const basic_vector<T, N, _R>& vector) const {
-        static constexpr auto operand = F<T>();
-
-        R result;
-        for (size_t i = 0; i < N; i++)
-            result.scalars[i] = operand(scalars[i], vector.scalars[i]);
-        return result;
-    }
-
-    template <class T, size_t N, class R>
-    template <template <class> class F, class _R>
-    R& basic_vector<T, N, R>::assign_operator_vector(const basic_vector<T, N, _R>& vector) {
+    template <template <class> class F, class E, class _R>
+    R& basic_vector<T, N, R>::assign_operator_vector(const vector_expression<E, T, N, _R>& vector) {
         static constexpr auto operand = F<T>();
+        const E& expression = static_cast<const E&>(vector);
 
         for (size_t i = 0; i < N; i++)
-            scalars[i] = operand(scalars[i], vector.scalars[i]);
+            scalars[i] = operand(scalars[i], expression[i]);
         return static_cast<R&>(*this);
     }
 
-    template <class T, size_t N, class R>
-    template <template <class> class F>
-    R basic_vector<T, N, R>::copy_operator_scalar(T scalar) const {
-        static constexpr auto operand = F<T>();
-
-        R result;
-        for (size_t i = 0; i < N; i++)
-            result.scalars[i] = operand(scalars[i], scalar);
-        return result;
-    }
-
     template <class T, size_t N, class R>
     template <template <class> class F>
     R& basic_vector<T, N, R>::assign_operator_scalar(T scalar) {
@@ -153,61 +374,15 @@ namespace geometry {
     }
 
     template <class T, size_t N, class R>
-    template <class _R>
-    T basic_vector<T, N, R>::operator*(const basic_vector<T, N, _R>& vector) const {
-        T result = 0;
-        for (size_t i = 0; i < N; i++)
-            result += scalars[i] * vector.scalars[i];
-        return result;
-    }
-
-    template <class T, size_t N, class R>
-    template <class _R>
-    R basic_vector<T, N, R>::operator+(const basic_vector<T, N, _R>& vector) const {
-        return copy_operator_vector<std::plus, _R>(vector);
-    }
-
-    template <class T, size_t N, class R>
-    template <class _R>
-    R basic_vector<T, N, R>::operator-(const basic_vector<T, N, _R>& vector) const {
-        return copy_operator_vector<std::minus, _R>(vector);
-    }
-
-    template <class T, size_t N, class R>
-    template <class _R>
-    R& basic_vector<T, N, R>::operator+=(const basic_vector<T, N, _R>& vector) {
-        return assign_operator_vector<std::plus, _R>(vector);
-    }
-
-    template <class T, size_t N, class R>
-    template <class _R>
-    R& basic_vector<T, N, R>::operator-=(const basic_vector<T, N, _R>& vector) {
-        return assign_operator_vector<std::minus, _R>(vector);
-    }
-
-    template <class T, size_t N, class R>
-    R basic_vector<T, N, R>::operator+(T scalar) const {
-        return copy_operator_scalar<std::plus>(scalar);
-    }
-
-    template <class T, size_t N, class R>
-    R basic_vector<T, N, R>::operator-(T scalar) const {
-        return copy_operator_scalar<std::minus>(scalar);
-    }
-
-    template <class T, size_t N, class R>
-    R basic_vector<T, N, R>::operator*(T scalar) const {
-        return copy_operator_scalar<std::multiplies>(scalar);
-    }
-
-    template <class T, size_t N, class R>
-    R basic_vector<T, N, R>::operator/(T scalar) const {
-        return copy_operator_scalar<std::divides>(scalar);
+    template <class E, class _R>
+    R& basic_vector<T, N, R>::operator+=(const vector_expression<E, T, N, _R>& vector) {
+        return assign_operator_vector<std::plus>(vector);
     }
 
     template <class T, size_t N, class R>
-    R basic_vector<T, N, R>::operator%(T scalar) const {
-        return copy_operator_scalar<std::modulus>(scalar);
+    template <class E, class _R>
+    R& basic_vector<T, N, R>::operator-=(const vector_expression<E, T, N, _R>& vector) {
+        return assign_operator_vector<std::minus>(vector);
     }
 
     template <class T, size_t N, class R>
@@ -236,10 +411,12 @@ namespace geometry {
     }
 
     template <class T, size_t N, class R>
-    template <class _R>
-    bool basic_vector<T, N, R>::operator==(const basic_vector<T, N, _R>& vector) const {
+    template <class E, class _R>
+    bool basic_vector<T, N, R>::operator==(const vector_expression<E, T, N, _R>& vector) const {
+        const E& expression = static_cast<const E&>(vector);
+
         for (size_t i = 0; i < N; i++)
-            if (scalars[i] != vector.scalars[i])
+            if (scalars[i] != expression[i])
                 return false;
         return true;
     }
@@ -280,6 +457,9 @@ namespace geometry {
     template <class T>
     class matrix3d;
 
+    template <class T>
+    class quaternion;
+
     template <class T>
     class vector3d : public basic_vector<T, 3, vector3d<T>> {
     public:
@@ -293,6 +473,9 @@ namespace geometry {
         void rotate(const vector3d<T>& point, const matrix3d<T>& rotation);
         void rotate(const matrix3d<T>& rotation);
 
+        void rotate(const vector3d<T>& point, const quaternion<T>& rotation);
+        void rotate(const quaternion<T>& rotation);
+
         void rotate_radians(const vector3d<T>& point, const vector3d<T>& radians);
         void rotate_radians(const vector3d<T>& radians);
 
@@ -327,6 +510,16 @@ namespace geometry {
         this->operator=(rotation * (*this));
     }
 
+    template <class T>
+    void vector3d<T>::rotate(const vector3d<T>& point, const quaternion<T>& rotation) {
+        this->operator=(rotation * (*this - point) + point);
+    }
+
+    template <class T>
+    void vector3d<T>::rotate(const quaternion<T>& rotation) {
+        this->operator=(rotation * (*this));
+    }
+
     template <class T>
     void vector3d<T>::rotate_radians(const vector3d<T>& point, const vector3d<T>& radians) {
         rotate(point, matrix3d<T>::rotation_radians(radians));
@@ -347,6 +540,48 @@ namespace geometry {
         rotate(matrix3d<T>::rotation_degrees(degrees));
     }
 
+    template <class T>
+    vector3d<T> cross(const vector3d<T>& lhs, const vector3d<T>& rhs) {
+        return vector3d<T>(lhs[1] * rhs[2] - lhs[2] * rhs[1],
+                           lhs[2] * rhs[0] - lhs[0] * rhs[2],
+                           lhs[0] * rhs[1] - lhs[1] * rhs[0]);
+    }
+
+    // every row needs the whole operand, so it is resolved once up front instead of per row,
+    // which also keeps v = m * v safe from aliasing, the matrix is copied so a temporary one cannot dangle
+    template <class M, class T, size_t N, class R>
+    class matrix_vector_expression : public vector_expression<matrix_vector_expression<M, T, N, R>, T, N, R> {
+    public:
+        template <class E, class _R>
+        matrix_vector_expression(const M& matrix, const vector_expression<E, T, N, _R>& vector) noexcept;
+
+        T operator[](size_t i) const;
+
+    private:
+        M matrix;
+        T operand[N];
+    };
+
+    template <class M, class T, size_t N, class R>
+    template <class E, class _R>
+    matrix_vector_expression<M, T, N, R>::matrix_vector_expression(const M& matrix,
+                                                                   const vector_expression<E, T, N, _R>& vector) noexcept
+        : matrix(matrix)
+    {
+        const E& expression = static_cast<const E&>(vector);
+
+        for (size_t i = 0; i < N; i++)
+            operand[i] = expression[i];
+    }
+
+    template <class M, class T, size_t N, class R>
+    T matrix_vector_expression<M, T, N, R>::operator[](size_t i) const {
+        T result = 0;
+        for (size_t j = 0; j < N; j++)
+            result += matrix[i][j] * operand[j];
+        return result;
+    }
+
     template <class T, size_t N, class R1, class R2>
     class basic_matrix {
     public:
@@ -365,8 +600,8 @@ namespace geometry {
         template <class _R1, class _R2>
         R1& operator*=(const basic_matrix<T, N, _R1, _R2>& matrix);
 
-        template <class _R2>
-        R2 operator*(const basic_vector<T, N, _R2>& vector) const;
+        template <class E, class _R2>
+        matrix_vector_expression<R1, T, N, R2> operator*(const vector_expression<E, T, N, _R2>& vector) const;
 
         template <class _R1, class _R2>
         R1 operator+(const basic_matrix<T, N, _R1, _R2>& matrix) const;
@@ -490,30 +725,25 @@ namespace geometry {
     }
 
     template <class T, size_t N, class R1, class R2>
-    template <class _R2>
-    R2 basic_matrix<T, N, R1, R2>::operator*(const basic_vector<T, N, _R2>& vector) const {
-        R2 result;
-        for (size_t i = 0; i < N; i++)
-            result[i] = vectors[i] * vector;
-        return result;
+    template <class E, class _R2>
+    matrix_vector_expression<R1, T, N, R2> basic_matrix<T, N, R1, R2>::operator*(const vector_expression<E, T, N, _R2>& vector) const {
+        return matrix_vector_expression<R1, T, N, R2>(static_cast<const R1&>(*this), vector);
     }
 
     template <class T, size_t N, class R1, class R2>
     template <class _R1, class _R2>
     R1& basic_matrix<T, N, R1, R2>::operator*=(const basic_matrix<T, N, _R1, _R2>& matrix) {
-        for (size_t x = 0; x < N; x++)
-            for (size_t y = 0; y < N; y++)
-                vectors[x][y] = vectors[x] * matrix.vectors[y];
-        return static_cast<R1&>(*this);
+        return static_cast<R1&>(*this) = operator*(matrix);
     }
 
     template <class T, size_t N, class R1, class R2>
     template <class _R1, class _R2>
     R1 basic_matrix<T, N, R1, R2>::operator*(const basic_matrix<T, N, _R1, _R2>& matrix) const {
-        R1 result;
+        R1 result(0);
         for (size_t x = 0; x < N; x++)
-            for (size_t y = 0; y < N; y++)
-                result[x][y] = vectors[x] * matrix.vectors[y];
+            for (size_t k = 0; k < N; k++)
+                for (size_t y = 0; y < N; y++)
+                    result[x][y] += vectors[x][k] * matrix.vectors[k][y];
         return result;
     }
 
@@ -631,11 +861,25 @@ namespace geometry {
         explicit matrix3d(const T (&scalars)[9]) noexcept;
         explicit matrix3d(T scalar) noexcept;
 
+        template <class P = default_trig>
         static matrix3d<T> rotation_radians(T x_radians, T y_radians, T z_radians);
+        template <class P = default_trig>
         static matrix3d<T> rotation_radians(const vector3d<T>& radians);
+        template <class P = default_trig>
+        static void rotation_radians(const vector3d<T>* radians, matrix3d<T>* rotations, size_t count);
 
+        template <class P = default_trig>
         static matrix3d<T> rotation_degrees(T x_degrees, T y_degrees, T z_degrees);
+        template <class P = default_trig>
         static matrix3d<T> rotation_degrees(const vector3d<T>& degrees);
+        template <class P = default_trig>
+        static void rotation_degrees(const vector3d<T>* degrees, matrix3d<T>* rotations, size_t count);
+
+    protected:
+        static matrix3d<T> rotation_sincos(T x_sine, T x_cosine, T y_sine, T y_cosine, T z_sine, T z_cosine);
+
+        template <class P>
+        static void rotation_batch(const vector3d<T>* angles, matrix3d<T>* rotations, size_t count, T scale);
     };
 
     template <class T>
@@ -647,35 +891,978 @@ namespace geometry {
         : basic_matrix<T, 3, matrix3d<T>, vector3d<T>>(scalar) {}
 
     template <class T>
-    matrix3d<T> matrix3d<T>::rotation_radians(T x_radians, T y_radians, T z_radians) {
+    matrix3d<T> matrix3d<T>::rotation_sincos(T x_sine, T x_cosine, T y_sine, T y_cosine, T z_sine, T z_cosine) {
         return matrix3d<T>({
-             cos(y_radians) * cos(z_radians),
-             cos(x_radians) * sin(z_radians) + sin(x_radians) * sin(y_radians) * cos(z_radians),
-             sin(x_radians) * sin(z_radians) - cos(x_radians) * sin(y_radians) * cos(z_radians),
+             y_cosine * z_cosine,
+             x_cosine * z_sine + x_sine * y_sine * z_cosine,
+             x_sine * z_sine - x_cosine * y_sine * z_cosine,
 
-            -cos(y_radians) * sin(z_radians),
-             cos(x_radians) * cos(z_radians) - sin(x_radians) * sin(y_radians) * sin(z_radians),
-             sin(x_radians) * cos(z_radians) + cos(x_radians) * sin(y_radians) * sin(z_radians),
+            -y_cosine * z_sine,
+             x_cosine * z_cosine - x_sine * y_sine * z_sine,
+             x_sine * z_cosine + x_cosine * y_sine * z_sine,
 
-             sin(y_radians),
-            -sin(x_radians) * cos(y_radians),
-             cos(x_radians) * cos(y_radians)
+             y_sine,
+            -x_sine * y_cosine,
+             x_cosine * y_cosine
         });
     }
 
+    // angles are gathered per axis in chunks so P::sincos runs over contiguous streams
+    template <class T>
+    template <class P>
+    void matrix3d<T>::rotation_batch(const vector3d<T>* angles, matrix3d<T>* rotations, size_t count, T scale) {
+        static constexpr size_t chunk = 64;
+        T radians[3][chunk], sines[3][chunk], cosines[3][chunk];
+
+        for (size_t i = 0; i < count; i += chunk) {
+            const size_t n = std::min(chunk, count - i);
+
+            for (size_t j = 0; j < n; j++)
+                for (size_t a = 0; a < 3; a++)
+                    radians[a][j] = angles[i + j][a] * scale;
+
+            for (size_t a = 0; a < 3; a++)
+                sincos<P>(radians[a], sines[a], cosines[a], n);
+
+            for (size_t j = 0; j < n; j++)
+                rotations[i + j] = rotation_sincos(sines[0][j], cosines[0][j], sines[1][j], cosines[1][j], sines[2][j], cosines[2][j]);
+        }
+    }
+
+    template <class T>
+    template <class P>
+    matrix3d<T> matrix3d<T>::rotation_radians(T x_radians, T y_radians, T z_radians) {
+        T x_sine, x_cosine, y_sine, y_cosine, z_sine, z_cosine;
+
+        P::sincos(x_radians, x_sine, x_cosine);
+        P::sincos(y_radians, y_sine, y_cosine);
+        P::sincos(z_radians, z_sine, z_cosine);
+
+        return rotation_sincos(x_sine, x_cosine, y_sine, y_cosine, z_sine, z_cosine);
+    }
+
     template <class T>
+    template <class P>
     matrix3d<T> matrix3d<T>::rotation_radians(const vector3d<T>& radians) {
-        return rotation_radians(radians[0], radians[1], radians[2]);
+        return rotation_radians<P>(radians[0], radians[1], radians[2]);
+    }
+
+    template <class T>
+    template <class P>
+    void matrix3d<T>::rotation_radians(const vector3d<T>* radians, matrix3d<T>* rotations, size_t count) {
+        rotation_batch<P>(radians, rotations, count, 1);
     }
 
     template <class T>
+    template <class P>
     matrix3d<T> matrix3d<T>::rotation_degrees(T x_degrees, T y_degrees, T z_degrees) {
-        return rotation_radians(to_radians(x_degrees), to_radians(y_degrees), to_radians(z_degrees));
+        return rotation_radians<P>(to_radians(x_degrees), to_radians(y_degrees), to_radians(z_degrees));
     }
 
     template <class T>
+    template <class P>
     matrix3d<T> matrix3d<T>::rotation_degrees(const vector3d<T>& degrees) {
-        return rotation_degrees(degrees[0], degrees[1], degrees[2]);
+        return rotation_degrees<P>(degrees[0], degrees[1], degrees[2]);
+    }
+
+    template <class T>
+    template <class P>
+    void matrix3d<T>::rotation_degrees(const vector3d<T>* degrees, matrix3d<T>* rotations, size_t count) {
+        rotation_batch<P>(degrees, rotations, count, static_cast<T>(TO_RADIANS));
+    }
+
+    template <class T>
+    class matrix4d : public basic_matrix<T, 4, matrix4d<T>, vector<T, 4>> {
+    public:
+        matrix4d() = default;
+        explicit matrix4d(const T (&scalars)[16]) noexcept;
+        explicit matrix4d(T scalar) noexcept;
+
+        static matrix4d<T> identity() noexcept;
+    };
+
+    template <class T>
+    matrix4d<T>::matrix4d(const T (&scalars)[16]) noexcept
+        : basic_matrix<T, 4, matrix4d<T>, vector<T, 4>>(scalars) {}
+
+    template <class T>
+    matrix4d<T>::matrix4d(T scalar) noexcept
+        : basic_matrix<T, 4, matrix4d<T>, vector<T, 4>>(scalar) {}
+
+    template <class T>
+    matrix4d<T> matrix4d<T>::identity() noexcept {
+        matrix4d<T> result(0);
+        for (size_t i = 0; i < 4; i++)
+            result[i][i] = 1;
+        return result;
+    }
+
+    // unit quaternion (w, x, y, z), composes like matrix3d: (a * b).matrix() == a.matrix() * b.matrix()
+    template <class T>
+    class quaternion : public basic_vector<T, 4, quaternion<T>> {
+    public:
+        quaternion() = default;
+        quaternion(T w_scalar, T x_scalar, T y_scalar, T z_scalar) noexcept;
+        explicit quaternion(const T (&scalars)[4]) noexcept;
+        explicit quaternion(const matrix3d<T>& rotation);
+
+        static quaternion<T> identity() noexcept;
+
+        static quaternion<T> axis_radians(const vector3d<T>& axis, T radians);
+        static quaternion<T> axis_degrees(const vector3d<T>& axis, T degrees);
+
+        template <class P = default_trig>
+        static quaternion<T> rotation_radians(T x_radians, T y_radians, T z_radians);
+        template <class P = default_trig>
+        static quaternion<T> rotation_radians(const vector3d<T>& radians);
+
+        template <class P = default_trig>
+        static quaternion<T> rotation_degrees(T x_degrees, T y_degrees, T z_degrees);
+        template <class P = default_trig>
+        static quaternion<T> rotation_degrees(const vector3d<T>& degrees);
+
+        static quaternion<T> slerp(const quaternion<T>& from, quaternion<T> to, T fraction); // intentional copy
+        static quaternion<T> nlerp(const quaternion<T>& from, quaternion<T> to, T fraction); // intentional copy
+
+        using basic_vector<T, 4, quaternion<T>>::operator*=;
+
+        quaternion<T> operator*(const quaternion<T>& rotation) const;
+        quaternion<T>& operator*=(const quaternion<T>& rotation);
+
+        vector3d<T> operator*(const vector3d<T>& vector) const;
+
+        T dot(const quaternion<T>& rotation) const;
+
+        quaternion<T> conjugate() const;
+        quaternion<T> inverse() const;
+
+        T norm() const;
+        quaternion<T> normalized() const;
+
+        matrix3d<T> matrix() const;
+
+        vector3d<T> radians() const;
+        vector3d<T> degrees() const;
+    };
+
+    template <class T>
+    quaternion<T>::quaternion(T w_scalar, T x_scalar, T y_scalar, T z_scalar) noexcept
+        : basic_vector<T, 4, quaternion<T>>({w_scalar, x_scalar, y_scalar, z_scalar}) {}
+
+    template <class T>
+    quaternion<T>::quaternion(const T (&scalars)[4]) noexcept
+        : basic_vector<T, 4, quaternion<T>>(scalars) {}
+
+    template <class T>
+    quaternion<T>::quaternion(const matrix3d<T>& rotation) { // based on: Shepperd, "Quaternion from rotation matrix" (1978)
+        const T trace = rotation[0][0] + rotation[1][1] + rotation[2][2];
+        auto& q = this->scalars;
+
+        if (trace > 0) {
+            T s = std::sqrt(trace + 1) * 2;
+            q[0] = s / 4;
+            q[1] = (rotation[2][1] - rotation[1][2]) / s;
+            q[2] = (rotation[0][2] - rotation[2][0]) / s;
+            q[3] = (rotation[1][0] - rotation[0][1]) / s;
+        } else if (rotation[0][0] > rotation[1][1] && rotation[0][0] > rotation[2][2]) {
+            T s = std::sqrt(1 + rotation[0][0] - rotation[1][1] - rotation[2][2]) * 2;
+            q[0] = (rotation[2][1] - rotation[1][2]) / s;
+            q[1] = s / 4;
+            q[2] = (rotation[0][1] + rotation[1][0]) / s;
+            q[3] = (rotation[0][2] + rotation[2][0]) / s;
+        } else if (rotation[1][1] > rotation[2][2]) {
+            T s = std::sqrt(1 + rotation[1][1] - rotation[0][0] - rotation[2][2]) * 2;
+            q[0] = (rotation[0][2] - rotation[2][0]) / s;
+            q[1] = (rotation[0][1] + rotation[1][0]) / s;
+            q[2] = s / 4;
+            q[3] = (rotation[1][2] + rotation[2][1]) / s;
+        } else {
+            T s = std::sqrt(1 + rotation[2][2] - rotation[0][0] - rotation[1][1]) * 2;
+            q[0] = (rotation[1][0] - rotation[0][1]) / s;
+            q[1] = (rotation[0][2] + rotation[2][0]) / s;
+            q[2] = (rotation[1][2] + rotation[2][1]) / s;
+            q[3] = s / 4;
+        }
+    }
+
+    template <class T>
+    quaternion<T> quaternion<T>::identity() noexcept {
+        return quaternion<T>(1, 0, 0, 0);
+    }
+
+    template <class T>
+    quaternion<T> quaternion<T>::axis_radians(const vector3d<T>& axis, T radians) {
+        T length = std::sqrt(axis * axis);
+        T s = std::sin(radians / 2) / length;
+
+        return quaternion<T>(std::cos(radians / 2), axis[0] * s, axis[1] * s, axis[2] * s);
+    }
+
+    template <class T>
+    quaternion<T> quaternion<T>::axis_degrees(const vector3d<T>& axis, T degrees) {
+        return axis_radians(axis, to_radians(degrees));
+    }
+
+    // same convention as matrix3d::rotation_radians, which is Rz(-z) * Ry(-y) * Rx(-x)
+    template <class T>
+    template <class P>
+    quaternion<T> quaternion<T>::rotation_radians(T x_radians, T y_radians, T z_radians) {
+        T cx, sx, cy, sy, cz, sz;
+
+        P::sincos(x_radians / 2, sx, cx);
+        P::sincos(y_radians / 2, sy, cy);
+        P::sincos(z_radians / 2, sz, cz);
+
+        return quaternion<T>(
+             cz * cy * cx - sz * sy * sx,
+            -cz * cy * sx - sz * sy * cx,
+            -cz * sy * cx + sz * cy * sx,
+            -sz * cy * cx - cz * sy * sx
+        );
+    }
+
+    template <class T>
+    template <class P>
+    quaternion<T> quaternion<T>::rotation_radians(const vector3d<T>& radians) {
+        return rotation_radians<P>(radians[0], radians[1], radians[2]);
+    }
+
+    template <class T>
+    template <class P>
+    quaternion<T> quaternion<T>::rotation_degrees(T x_degrees, T y_degrees, T z_degrees) {
+        return rotation_radians<P>(to_radians(x_degrees), to_radians(y_degrees), to_radians(z_degrees));
+    }
+
+    template <class T>
+    template <class P>
+    quaternion<T> quaternion<T>::rotation_degrees(const vector3d<T>& degrees) {
+        return rotation_degrees<P>(degrees[0], degrees[1], degrees[2]);
+    }
+
+    template <class T>
+    quaternion<T> quaternion<T>::slerp(const quaternion<T>& from, quaternion<T> to, T fraction) {
+        T cosine = from.dot(to);
+
+        if (cosine < 0) {
+            to *= -1;
+            cosine = -cosine;
+        }
+
+        if (cosine > T(0.9995))
+            return nlerp(from, to, fraction);
+
+        T angle = std::acos(cosine);
+        T sine = std::sin(angle);
+
+        return (from * std::sin((1 - fraction) * angle) + to * std::sin(fraction * angle)) / sine;
+    }
+
+    template <class T>
+    quaternion<T> quaternion<T>::nlerp(const quaternion<T>& from, quaternion<T> to, T fraction) {
+        if (from.dot(to) < 0)
+            to *= -1;
+
+        return quaternion<T>(from * (1 - fraction) + to * fraction).normalized();
+    }
+
+    template <class T>
+    quaternion<T> quaternion<T>::operator*(const quaternion<T>& rotation) const {
+        const auto& a = this->scalars;
+        const auto& b = rotation.scalars;
+
+        return quaternion<T>(
+            a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3],
+            a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2],
+            a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1],
+            a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0]
+        );
+    }
+
+    template <class T>
+    quaternion<T>& quaternion<T>::operator*=(const quaternion<T>& rotation) {
+        return this->operator=(operator*(rotation));
+    }
+
+    template <class T>
+    vector3d<T> quaternion<T>::operator*(const vector3d<T>& vector) const {
+        const T w = this->scalars[0];
+        const vector3d<T> u(this->scalars[1], this->scalars[2], this->scalars[3]);
+
+        // v + 2w (u x v) + 2 u x (u x v)
+        vector3d<T> t(2 * (u[1] * vector[2] - u[2] * vector[1]),
+                      2 * (u[2] * vector[0] - u[0] * vector[2]),
+                      2 * (u[0] * vector[1] - u[1] * vector[0]));
+
+        return vector3d<T>(vector[0] + w * t[0] + u[1] * t[2] - u[2] * t[1],
+                           vector[1] + w * t[1] + u[2] * t[0] - u[0] * t[2],
+                           vector[2] + w * t[2] + u[0] * t[1] - u[1] * t[0]);
+    }
+
+    template <class T>
+    T quaternion<T>::dot(const quaternion<T>& rotation) const {
+        return geometry::dot(*this, rotation);
+    }
+
+    template <class T>
+    quaternion<T> quaternion<T>::conjugate() const {
+        return quaternion<T>(this->scalars[0], -this->scalars[1], -this->scalars[2], -this->scalars[3]);
+    }
+
+    template <class T>
+    quaternion<T> quaternion<T>::inverse() const {
+        return conjugate() / dot(*this);
+    }
+
+    template <class T>
+    T quaternion<T>::norm() const {
+        return std::sqrt(dot(*this));
+    }
+
+    template <class T>
+    quaternion<T> quaternion<T>::normalized() const {
+        return *this / norm();
+    }
+
+    template <class T>
+    matrix3d<T> quaternion<T>::matrix() const {
+        const T w = this->scalars[0], x = this->scalars[1], y = this->scalars[2], z = this->scalars[3];
+
+        return matrix3d<T>({
+            1 - 2 * (y * y + z * z),     2 * (x * y - w * z),     2 * (x * z + w * y),
+                2 * (x * y + w * z), 1 - 2 * (x * x + z * z),     2 * (y * z - w * x),
+                2 * (x * z - w * y),     2 * (y * z + w * x), 1 - 2 * (x * x + y * y)
+        });
+    }
+
+    template <class T>
+    vector3d<T> quaternion<T>::radians() const {
+        const T w = this->scalars[0], x = this->scalars[1], y = this->scalars[2], z = this->scalars[3];
+
+        // entries of matrix() that the euler convention of matrix3d::rotation_radians pins down
+        const T m00 = 1 - 2 * (y * y + z * z), m10 = 2 * (x * y + w * z);
+        const T m11 = 1 - 2 * (x * x + z * z), m12 = 2 * (y * z - w * x);
+        const T m20 = 2 * (x * z - w * y), m21 = 2 * (y * z + w * x), m22 = 1 - 2 * (x * x + y * y);
+
+        const T y_cosine = std::sqrt(m00 * m00 + m10 * m10);
+        const T y_radians = std::atan2(m20, y_cosine);
+
+        if (y_cosine < 16 * std::numeric_limits<T>::epsilon())
+            return vector3d<T>(std::atan2(m12, m11), y_radians, 0);
+
+        return vector3d<T>(std::atan2(-m21, m22), y_radians, std::atan2(-m10, m00));
+    }
+
+    template <class T>
+    vector3d<T> quaternion<T>::degrees() const {
+        vector3d<T> angles = radians();
+
+        for (size_t i = 0; i < 3; i++)
+            angles[i] = to_degrees(angles[i]);
+        return angles;
+    }
+
+    template <class T, size_t A>
+    class aligned_allocator {
+    public:
+        using value_type = T;
+
+        template <class U>
+        struct rebind {
+            using other = aligned_allocator<U, A>;
+        };
+
+        aligned_allocator() noexcept = default;
+
+        template <class U>
+        aligned_allocator(const aligned_allocator<U, A>&) noexcept {}
+
+        T* allocate(size_t size);
+        void deallocate(T* pointer, size_t size) noexcept;
+
+        template <class U>
+        bool operator==(const aligned_allocator<U, A>&) const noexcept { return true; }
+
+        template <class U>
+        bool operator!=(const aligned_allocator<U, A>&) const noexcept { return false; }
+    };
+
+    template <class T, size_t A>
+    T* aligned_allocator<T, A>::allocate(size_t size) {
+        return static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t(A)));
+    }
+
+    template <class T, size_t A>
+    void aligned_allocator<T, A>::deallocate(T* pointer, size_t) noexcept {
+        ::operator delete(pointer, std::align_val_t(A));
+    }
+
+    template <class T>
+    class vertex_buffer3d;
+
+    template <class T>
+    class vertex_reference3d {
+    public:
+        vertex_reference3d() = delete;
+        vertex_reference3d(const vertex_reference3d<T>& reference) noexcept = default;
+        explicit vertex_reference3d(vertex_buffer3d<T>& buffer, size_t index) noexcept;
+
+        operator vector3d<T>() const;
+
+        vertex_reference3d<T>& operator=(const vector3d<T>& vertex);
+        vertex_reference3d<T>& operator=(const vertex_reference3d<T>& reference);
+
+        T& operator[](size_t axis) const;
+
+        vertex_reference3d<T>& operator+=(const vector3d<T>& vector);
+        vertex_reference3d<T>& operator-=(const vector3d<T>& vector);
+
+    private:
+        vertex_buffer3d<T>* buffer;
+        size_t index;
+    };
+
+    template <class T, bool C>
+    class vertex_iterator3d {
+    public:
+        using buffer_type = typename std::conditional<C, const vertex_buffer3d<T>, vertex_buffer3d<T>>::type;
+
+        using iterator_category = std::random_access_iterator_tag;
+
+        using value_type = vector3d<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = typename std::conditional<C, vector3d<T>, vertex_reference3d<T>>::type;
+
+        vertex_iterator3d() noexcept = default;
+        explicit vertex_iterator3d(buffer_type& buffer, size_t index) noexcept;
+        vertex_iterator3d(const vertex_iterator3d<T, false>& iterator) noexcept;
+
+        reference operator*() const;
+        reference operator[](difference_type offset) const;
+
+        vertex_iterator3d<T, C>& operator++();
+        const vertex_iterator3d<T, C> operator++(int);
+
+        vertex_iterator3d<T, C>& operator--();
+        const vertex_iterator3d<T, C> operator--(int);
+
+        vertex_iterator3d<T, C>& operator+=(difference_type offset);
+        vertex_iterator3d<T, C>& operator-=(difference_type offset);
+
+        vertex_iterator3d<T, C> operator+(difference_type offset) const;
+        vertex_iterator3d<T, C> operator-(difference_type offset) const;
+        difference_type operator-(const vertex_iterator3d<T, C>& rhs) const;
+
+        bool operator==(const vertex_iterator3d<T, C>& rhs) const;
+        bool operator!=(const vertex_iterator3d<T, C>& rhs) const;
+        bool operator<(const vertex_iterator3d<T, C>& rhs) const;
+        bool operator>(const vertex_iterator3d<T, C>& rhs) const;
+        bool operator<=(const vertex_iterator3d<T, C>& rhs) const;
+        bool operator>=(const vertex_iterator3d<T, C>& rhs) const;
+
+    private:
+        friend class vertex_iterator3d<T, true>;
+
+        buffer_type* buffer = nullptr;
+        size_t index = 0;
+    };
+
+    // vertexes stored as three aligned per axis streams instead of interleaved xyz triples
+    template <class T>
+    class vertex_buffer3d {
+    public:
+        static constexpr size_t alignment = 32;
+
+        using axis_type = std::vector<T, aligned_allocator<T, alignment>>;
+
+        using value_type = vector3d<T>;
+        using reference = vertex_reference3d<T>;
+        using const_reference = vector3d<T>;
+
+        using iterator = vertex_iterator3d<T, false>;
+        using const_iterator = vertex_iterator3d<T, true>;
+
+        vertex_buffer3d() noexcept = default;
+        explicit vertex_buffer3d(size_t size);
+        vertex_buffer3d(const std::initializer_list<vector3d<T>>& vertexes);
+        explicit vertex_buffer3d(const std::vector<vector3d<T>>& vertexes);
+
+        size_t size() const noexcept;
+        bool empty() const noexcept;
+
+        void reserve(size_t size);
+        void resize(size_t size);
+        void clear() noexcept;
+
+        void push_back(const vector3d<T>& vertex);
+
+        reference operator[](size_t index);
+        const_reference operator[](size_t index) const;
+
+        T* data(size_t axis) noexcept;
+        const T* data(size_t axis) const noexcept;
+
+        iterator begin() noexcept;
+        const_iterator begin() const noexcept;
+
+        iterator end() noexcept;
+        const_iterator end() const noexcept;
+
+    protected:
+        axis_type axes[3];
+    };
+
+    template <class T>
+    vertex_reference3d<T>::vertex_reference3d(vertex_buffer3d<T>& buffer, size_t index) noexcept
+        : buffer(&buffer), index(index) {}
+
+    template <class T>
+    vertex_reference3d<T>::operator vector3d<T>() const {
+        return vector3d<T>(buffer->data(0)[index], buffer->data(1)[index], buffer->data(2)[index]);
+    }
+
+    template <class T>
+    vertex_reference3d<T>& vertex_reference3d<T>::operator=(const vector3d<T>& vertex) {
+        for (size_t i = 0; i < 3; i++)
+            buffer->data(i)[index] = vertex[i];
+        return *this;
+    }
+
+    template <class T>
+    vertex_reference3d<T>& vertex_reference3d<T>::operator=(const vertex_reference3d<T>& reference) {
+        return operator=(static_cast<vector3d<T>>(reference));
+    }
+
+    template <class T>
+    T& vertex_reference3d<T>::operator[](size_t axis) const {
+        return buffer->data(axis)[index];
+    }
+
+    template <class T>
+    vertex_reference3d<T>& vertex_reference3d<T>::operator+=(const vector3d<T>& vector) {
+        for (size_t i = 0; i < 3; i++)
+            buffer->data(i)[index] += vector[i];
+        return *this;
+    }
+
+    template <class T>
+    vertex_reference3d<T>& vertex_reference3d<T>::operator-=(const vector3d<T>& vector) {
+        for (size_t i = 0; i < 3; i++)
+            buffer->data(i)[index] -= vector[i];
+        return *this;
+    }
+
+    template <class T>
+    void swap(vertex_reference3d<T> lhs, vertex_reference3d<T> rhs) {
+        vector3d<T> vertex = lhs;
+        lhs = rhs;
+        rhs = vertex;
+    }
+
+    template <class T, bool C>
+    vertex_iterator3d<T, C>::vertex_iterator3d(buffer_type& buffer, size_t index) noexcept
+        : buffer(&buffer), index(index) {}
+
+    template <class T, bool C>
+    vertex_iterator3d<T, C>::vertex_iterator3d(const vertex_iterator3d<T, false>& iterator) noexcept
+        : buffer(iterator.buffer), index(iterator.index) {}
+
+    template <class T, bool C>
+    typename vertex_iterator3d<T, C>::reference vertex_iterator3d<T, C>::operator*() const {
+        return (*buffer)[index];
+    }
+
+    template <class T, bool C>
+    typename vertex_iterator3d<T, C>::reference vertex_iterator3d<T, C>::operator[](difference_type offset) const {
+        return (*buffer)[index + offset];
+    }
+
+    template <class T, bool C>
+    vertex_iterator3d<T, C>& vertex_iterator3d<T, C>::operator++() {
+        ++index;
+        return *this;
+    }
+
+    template <class T, bool C>
+    const vertex_iterator3d<T, C> vertex_iterator3d<T, C>::operator++(int) {
+        vertex_iterator3d<T, C> iterator(*this);
+        operator++();
+
+        return iterator;
+    }
+
+    template <class T, bool C>
+    vertex_iterator3d<T, C>& vertex_iterator3d<T, C>::operator--() {
+        --index;
+        return *this;
+    }
+
+    template <class T, bool C>
+    const vertex_iterator3d<T, C> vertex_iterator3d<T, C>::operator--(int) {
+        vertex_iterator3d<T, C> iterator(*this);
+        operator--();
+
+        return iterator;
+    }
+
+    template <class T, bool C>
+    vertex_iterator3d<T, C>& vertex_iterator3d<T, C>::operator+=(difference_type offset) {
+        index += offset;
+        return *this;
+    }
+
+    template <class T, bool C>
+    vertex_iterator3d<T, C>& vertex_iterator3d<T, C>::operator-=(difference_type offset) {
+        index -= offset;
+        return *this;
+    }
+
+    template <class T, bool C>
+    vertex_iterator3d<T, C> vertex_iterator3d<T, C>::operator+(difference_type offset) const {
+        return vertex_iterator3d<T, C>(*buffer, index + offset);
+    }
+
+    template <class T, bool C>
+    vertex_iterator3d<T, C> vertex_iterator3d<T, C>::operator-(difference_type offset) const {
+        return vertex_iterator3d<T, C>(*buffer, index - offset);
+    }
+
+    template <class T, bool C>
+    typename vertex_iterator3d<T, C>::difference_type vertex_iterator3d<T, C>::operator-(const vertex_iterator3d<T, C>& rhs) const {
+        return static_cast<difference_type>(index) - static_cast<difference_type>(rhs.index);
+    }
+
+    template <class T, bool C>
+    bool vertex_iterator3d<T, C>::operator==(const vertex_iterator3d<T, C>& rhs) const {
+        return buffer == rhs.buffer && index == rhs.index;
+    }
+
+    template <class T, bool C>
+    bool vertex_iterator3d<T, C>::operator!=(const vertex_iterator3d<T, C>& rhs) const {
+        return !operator==(rhs);
+    }
+
+    template <class T, bool C>
+    bool vertex_iterator3d<T, C>::operator<(const vertex_iterator3d<T, C>& rhs) const {
+        return index < rhs.index;
+    }
+
+    template <class T, bool C>
+    bool vertex_iterator3d<T, C>::operator>(const vertex_iterator3d<T, C>& rhs) const {
+        return rhs < *this;
+    }
+
+    template <class T, bool C>
+    bool vertex_iterator3d<T, C>::operator<=(const vertex_iterator3d<T, C>& rhs) const {
+        return !(rhs < *this);
+    }
+
+    template <class T, bool C>
+    bool vertex_iterator3d<T, C>::operator>=(const vertex_iterator3d<T, C>& rhs) const {
+        return !(*this < rhs);
+    }
+
+    template <class T, bool C>
+    vertex_iterator3d<T, C> operator+(typename vertex_iterator3d<T, C>::difference_type offset, const vertex_iterator3d<T, C>& iterator) {
+        return iterator + offset;
+    }
+
+    template <class T>
+    vertex_buffer3d<T>::vertex_buffer3d(size_t size) {
+        resize(size);
+    }
+
+    template <class T>
+    vertex_buffer3d<T>::vertex_buffer3d(const std::initializer_list<vector3d<T>>& vertexes) {
+        reserve(vertexes.size());
+        for (auto& vertex : vertexes)
+            push_back(vertex);
+    }
+
+    template <class T>
+    vertex_buffer3d<T>::vertex_buffer3d(const std::vector<vector3d<T>>& vertexes) {
+        reserve(vertexes.size());
+        for (auto& vertex : vertexes)
+            push_back(vertex);
+    }
+
+    template <class T>
+    size_t vertex_buffer3d<T>::size() const noexcept {
+        return axes[0].size();
+    }
+
+    template <class T>
+    bool vertex_buffer3d<T>::empty() const noexcept {
+        return axes[0].empty();
+    }
+
+    template <class T>
+    void vertex_buffer3d<T>::reserve(size_t size) {
+        for (auto& axis : axes)
+            axis.reserve(size);
+    }
+
+    template <class T>
+    void vertex_buffer3d<T>::resize(size_t size) {
+        for (auto& axis : axes)
+            axis.resize(size);
+    }
+
+    template <class T>
+    void vertex_buffer3d<T>::clear() noexcept {
+        for (auto& axis : axes)
+            axis.clear();
+    }
+
+    template <class T>
+    void vertex_buffer3d<T>::push_back(const vector3d<T>& vertex) {
+        for (size_t i = 0; i < 3; i++)
+            axes[i].push_back(vertex[i]);
+    }
+
+    template <class T>
+    typename vertex_buffer3d<T>::reference vertex_buffer3d<T>::operator[](size_t index) {
+        return reference(*this, index);
+    }
+
+    template <class T>
+    typename vertex_buffer3d<T>::const_reference vertex_buffer3d<T>::operator[](size_t index) const {
+        return vector3d<T>(axes[0][index], axes[1][index], axes[2][index]);
+    }
+
+    template <class T>
+    T* vertex_buffer3d<T>::data(size_t axis) noexcept {
+        return axes[axis].data();
+    }
+
+    template <class T>
+    const T* vertex_buffer3d<T>::data(size_t axis) const noexcept {
+        return axes[axis].data();
+    }
+
+    template <class T>
+    typename vertex_buffer3d<T>::iterator vertex_buffer3d<T>::begin() noexcept {
+        return iterator(*this, 0);
+    }
+
+    template <class T>
+    typename vertex_buffer3d<T>::const_iterator vertex_buffer3d<T>::begin() const noexcept {
+        return const_iterator(*this, 0);
+    }
+
+    template <class T>
+    typename vertex_buffer3d<T>::iterator vertex_buffer3d<T>::end() noexcept {
+        return iterator(*this, size());
+    }
+
+    template <class T>
+    typename vertex_buffer3d<T>::const_iterator vertex_buffer3d<T>::end() const noexcept {
+        return const_iterator(*this, size());
+    }
+
+    // per axis streams need no shuffling, every lane is one vertex, source is written to
+    // destination[offset, offset + source.size()), which has to exist already, so several sources can share one buffer
+    template <class T>
+    static void transform_vertexes(const vertex_buffer3d<T>& source, vertex_buffer3d<T>& destination, size_t offset,
+                                   const matrix3d<T>& rotation, const vector3d<T>& translation) {
+        const size_t count = source.size();
+
+        const T* sx = source.data(0);
+        const T* sy = source.data(1);
+        const T* sz = source.data(2);
+
+        // an offset leaves the destination unaligned, only the source is loaded aligned
+        T* dx = destination.data(0) + offset;
+        T* dy = destination.data(1) + offset;
+        T* dz = destination.data(2) + offset;
+
+        const T m00 = rotation[0][0], m01 = rotation[0][1], m02 = rotation[0][2];
+        const T m10 = rotation[1][0], m11 = rotation[1][1], m12 = rotation[1][2];
+        const T m20 = rotation[2][0], m21 = rotation[2][1], m22 = rotation[2][2];
+        const T t0 = translation[0], t1 = translation[1], t2 = translation[2];
+
+        size_t i = 0;
+
+#if defined(__AVX__)
+        if constexpr (std::is_same<T, float>::value) {
+            const __m256 v00 = _mm256_set1_ps(m00), v01 = _mm256_set1_ps(m01), v02 = _mm256_set1_ps(m02);
+            const __m256 v10 = _mm256_set1_ps(m10), v11 = _mm256_set1_ps(m11), v12 = _mm256_set1_ps(m12);
+            const __m256 v20 = _mm256_set1_ps(m20), v21 = _mm256_set1_ps(m21), v22 = _mm256_set1_ps(m22);
+            const __m256 w0 = _mm256_set1_ps(t0), w1 = _mm256_set1_ps(t1), w2 = _mm256_set1_ps(t2);
+
+            for (; i + 8 <= count; i += 8) {
+                __m256 x = _mm256_load_ps(sx + i), y = _mm256_load_ps(sy + i), z = _mm256_load_ps(sz + i);
+
+                _mm256_storeu_ps(dx + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(v00, x), _mm256_mul_ps(v01, y)), _mm256_add_ps(_mm256_mul_ps(v02, z), w0)));
+                _mm256_storeu_ps(dy + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(v10, x), _mm256_mul_ps(v11, y)), _mm256_add_ps(_mm256_mul_ps(v12, z), w1)));
+                _mm256_storeu_ps(dz + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(v20, x), _mm256_mul_ps(v21, y)), _mm256_add_ps(_mm256_mul_ps(v22, z), w2)));
+            }
+        }
+#elif defined(__SSE__)
+        if constexpr (std::is_same<T, float>::value) {
+            const __m128 v00 = _mm_set1_ps(m00), v01 = _mm_set1_ps(m01), v02 = _mm_set1_ps(m02);
+            const __m128 v10 = _mm_set1_ps(m10), v11 = _mm_set1_ps(m11), v12 = _mm_set1_ps(m12);
+            const __m128 v20 = _mm_set1_ps(m20), v21 = _mm_set1_ps(m21), v22 = _mm_set1_ps(m22);
+            const __m128 w0 = _mm_set1_ps(t0), w1 = _mm_set1_ps(t1), w2 = _mm_set1_ps(t2);
+
+            for (; i + 4 <= count; i += 4) {
+                __m128 x = _mm_load_ps(sx + i), y = _mm_load_ps(sy + i), z = _mm_load_ps(sz + i);
+
+                _mm_storeu_ps(dx + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(v00, x), _mm_mul_ps(v01, y)), _mm_add_ps(_mm_mul_ps(v02, z), w0)));
+                _mm_storeu_ps(dy + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(v10, x), _mm_mul_ps(v11, y)), _mm_add_ps(_mm_mul_ps(v12, z), w1)));
+                _mm_storeu_ps(dz + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(v20, x), _mm_mul_ps(v21, y)), _mm_add_ps(_mm_mul_ps(v22, z), w2)));
+            }
+        }
+#endif
+
+        for (; i < count; i++) {
+            const T x = sx[i], y = sy[i], z = sz[i];
+
+            dx[i] = m00 * x + m01 * y + m02 * z + t0;
+            dy[i] = m10 * x + m11 * y + m12 * z + t1;
+            dz[i] = m20 * x + m21 * y + m22 * z + t2;
+        }
+    }
+
+    template <class T>
+    static void transform_vertexes(const vertex_buffer3d<T>& source, vertex_buffer3d<T>& destination,
+                                   const matrix3d<T>& rotation, const vector3d<T>& translation) {
+        destination.resize(source.size());
+        transform_vertexes(source, destination, 0, rotation, translation);
+    }
+
+    // homogeneous transform with an implied (0, 0, 0, 1) bottom row, stored as its linear part and translation,
+    // composes like matrix4d: (a * b).matrix() == a.matrix() * b.matrix()
+    template <class T>
+    class affine3d {
+    public:
+        affine3d() = default;
+        affine3d(const matrix3d<T>& linear, const vector3d<T>& translation) noexcept;
+        explicit affine3d(const matrix4d<T>& matrix) noexcept;
+
+        static affine3d<T> identity() noexcept;
+
+        static affine3d<T> translating(const vector3d<T>& translation);
+
+        static affine3d<T> rotating(const matrix3d<T>& rotation, const vector3d<T>& point);
+        static affine3d<T> rotating(const quaternion<T>& rotation, const vector3d<T>& point);
+
+        affine3d<T> operator*(const affine3d<T>& transform) const;
+        affine3d<T>& operator*=(const affine3d<T>& transform);
+
+        vector3d<T> operator*(const vector3d<T>& point) const;
+
+        affine3d<T> inverse() const;
+
+        void apply(const vertex_buffer3d<T>& source, vertex_buffer3d<T>& destination) const;
+        void apply(const vertex_buffer3d<T>& source, vertex_buffer3d<T>& destination, size_t offset) const;
+
+        const matrix3d<T>& linear() const;
+        const vector3d<T>& translation() const;
+
+        matrix4d<T> matrix() const;
+
+    protected:
+        matrix3d<T> _linear;
+        vector3d<T> _translation;
+    };
+
+    template <class T>
+    affine3d<T>::affine3d(const matrix3d<T>& linear, const vector3d<T>& translation) noexcept
+        : _linear(linear), _translation(translation) {}
+
+    template <class T>
+    affine3d<T>::affine3d(const matrix4d<T>& matrix) noexcept {
+        for (size_t x = 0; x < 3; x++) {
+            for (size_t y = 0; y < 3; y++)
+                _linear[x][y] = matrix[x][y];
+            _translation[x] = matrix[x][3];
+        }
+    }
+
+    template <class T>
+    affine3d<T> affine3d<T>::identity() noexcept {
+        return affine3d<T>(matrix3d<T>({1, 0, 0, 0, 1, 0, 0, 0, 1}), vector3d<T>(0));
+    }
+
+    template <class T>
+    affine3d<T> affine3d<T>::translating(const vector3d<T>& translation) {
+        return affine3d<T>(matrix3d<T>({1, 0, 0, 0, 1, 0, 0, 0, 1}), translation);
+    }
+
+    template <class T>
+    affine3d<T> affine3d<T>::rotating(const matrix3d<T>& rotation, const vector3d<T>& point) {
+        return affine3d<T>(rotation, vector3d<T>(point - rotation * point));
+    }
+
+    template <class T>
+    affine3d<T> affine3d<T>::rotating(const quaternion<T>& rotation, const vector3d<T>& point) {
+        return rotating(rotation.matrix(), point);
+    }
+
+    template <class T>
+    affine3d<T> affine3d<T>::operator*(const affine3d<T>& transform) const {
+        affine3d<T> result(_linear * transform._linear, _translation);
+        result._translation += _linear * transform._translation;
+        return result;
+    }
+
+    template <class T>
+    affine3d<T>& affine3d<T>::operator*=(const affine3d<T>& transform) {
+        return *this = operator*(transform);
+    }
+
+    template <class T>
+    vector3d<T> affine3d<T>::operator*(const vector3d<T>& point) const {
+        vector3d<T> result(_translation);
+        result += _linear * point;
+        return result;
+    }
+
+    // adjugate over determinant, so scaled and sheared parts invert as well as rigid ones
+    template <class T>
+    affine3d<T> affine3d<T>::inverse() const {
+        const matrix3d<T>& m = _linear;
+        matrix3d<T> inverse({
+            m[1][1] * m[2][2] - m[1][2] * m[2][1], m[0][2] * m[2][1] - m[0][1] * m[2][2], m[0][1] * m[1][2] - m[0][2] * m[1][1],
+            m[1][2] * m[2][0] - m[1][0] * m[2][2], m[0][0] * m[2][2] - m[0][2] * m[2][0], m[0][2] * m[1][0] - m[0][0] * m[1][2],
+            m[1][0] * m[2][1] - m[1][1] * m[2][0], m[0][1] * m[2][0] - m[0][0] * m[2][1], m[0][0] * m[1][1] - m[0][1] * m[1][0]
+        });
+
+        inverse /= m[0][0] * inverse[0][0] + m[0][1] * inverse[1][0] + m[0][2] * inverse[2][0];
+        return affine3d<T>(inverse, vector3d<T>(inverse * _translation * -1));
+    }
+
+    template <class T>
+    void affine3d<T>::apply(const vertex_buffer3d<T>& source, vertex_buffer3d<T>& destination) const {
+        transform_vertexes(source, destination, _linear, _translation);
+    }
+
+    // into destination[offset, offset + source.size()) of an already sized destination
+    template <class T>
+    void affine3d<T>::apply(const vertex_buffer3d<T>& source, vertex_buffer3d<T>& destination, size_t offset) const {
+        transform_vertexes(source, destination, offset, _linear, _translation);
+    }
+
+    template <class T>
+    const matrix3d<T>& affine3d<T>::linear() const {
+        return _linear;
+    }
+
+    template <class T>
+    const vector3d<T>& affine3d<T>::translation() const {
+        return _translation;
+    }
+
+    template <class T>
+    matrix4d<T> affine3d<T>::matrix() const {
+        matrix4d<T> result = matrix4d<T>::identity();
+        for (size_t x = 0; x < 3; x++) {
+            for (size_t y = 0; y < 3; y++)
+                result[x][y] = _linear[x][y];
+            result[x][3] = _translation[x];
+        }
+        return result;
     }
 }
 
@@ -684,7 +1871,7 @@ namespace geometry {
 namespace std {
     template <class T, size_t N, class R>
     struct hash<geometry::basic_vector<T, N, R>> {
-        static constexpr hash<T> hash_t;
+        static constexpr hash<T> hash_t{};
 
         template <class _R>
         size_t operator()(const geometry::basic_vector<T, N, _R>& vector) const { // based on: https://stackoverflow.com/a/27216842/8406095
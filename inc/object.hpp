@@ -3,8 +3,12 @@
 
 #include <iostream>
 #include <vector>
-#include <list>
+#include <optional>
+#include <limits>
+#include <memory>
+#include <variant>
 #include <stack>
+#include <deque>
 #include <unordered_map>
 #include <fstream>
 #include <sstream>
@@ -15,124 +19,314 @@ namespace object {
     using namespace geometry;
 
     template <class T>
-    class static_object3d {
+    class static_object3d;
+
+    // bounds padded to four lanes, the padding lane is zero on both sides so it never separates two boxes
+    template <class T>
+    class aabb3d {
     public:
-        using iterator = typename std::vector<vector3d<T>>::iterator;
-        using const_iterator = typename std::vector<vector3d<T>>::const_iterator;
+        aabb3d() noexcept;
+        aabb3d(const vector3d<T>& lower, const vector3d<T>& upper) noexcept;
+        explicit aabb3d(const vertex_buffer3d<T>& vertexes) noexcept;
+        explicit aabb3d(const static_object3d<T>& object);
 
-        static_object3d() = delete;
-        static_object3d(const std::initializer_list<vector3d<T>>& vertexes);
-        explicit static_object3d(const std::vector<vector3d<T>>& vertexes);
+        void update_bounds(const vertex_buffer3d<T>& vertexes);
+        void update_bounds(const static_object3d<T>& object);
 
-        iterator begin() noexcept;
-        const_iterator begin() const noexcept;
+        aabb3d<T> transformed(const affine3d<T>& transform) const;
+        aabb3d<T> merged(const aabb3d<T>& box) const;
+        aabb3d<T> expanded(T margin) const;
 
-        iterator end() noexcept;
-        const_iterator end() const noexcept;
+        bool check_bounds(const aabb3d<T>& box) const;
+        bool contains(const aabb3d<T>& box) const;
 
-        const std::vector<vector3d<T>>& vertexes() const;
-        const vector3d<T>& origin() const;
+        T area() const;
+
+        vector3d<T> lower() const;
+        vector3d<T> upper() const;
+
+        T lower(size_t axis) const;
+        T upper(size_t axis) const;
 
     protected:
-        std::vector<vector3d<T>> relative_vertexes;
-        vector3d<T> relative_origin;
+        alignas(4 * sizeof(T)) T lower_bounds[4];
+        alignas(4 * sizeof(T)) T upper_bounds[4];
     };
 
     template <class T>
-    static_object3d<T>::static_object3d(const std::initializer_list<vector3d<T>>& vertexes)
-        : static_object3d<T>::static_object3d(std::vector<vector3d<T>>(vertexes)) {}
+    aabb3d<T>::aabb3d() noexcept
+        : lower_bounds{std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), 0},
+          upper_bounds{std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(), 0} {}
 
     template <class T>
-    static_object3d<T>::static_object3d(const std::vector<vector3d<T>>& vertexes)
-        : relative_vertexes(vertexes),
-          relative_origin(0)
+    aabb3d<T>::aabb3d(const vector3d<T>& lower, const vector3d<T>& upper) noexcept
+        : lower_bounds{lower[0], lower[1], lower[2], 0},
+          upper_bounds{upper[0], upper[1], upper[2], 0} {}
+
+    template <class T>
+    aabb3d<T>::aabb3d(const vertex_buffer3d<T>& vertexes) noexcept
+        : aabb3d<T>::aabb3d()
     {
-        for (auto& vertex : vertexes)
-            relative_origin += vertex;
+        update_bounds(vertexes);
+    }
 
-        relative_origin /= vertexes.size();
+    template <class T>
+    aabb3d<T>::aabb3d(const static_object3d<T>& object)
+        : aabb3d<T>::aabb3d()
+    {
+        update_bounds(object);
     }
 
     template <class T>
-    typename static_object3d<T>::iterator static_object3d<T>::begin() noexcept {
-        return relative_vertexes.begin();
+    void aabb3d<T>::update_bounds(const vertex_buffer3d<T>& vertexes) {
+        for (size_t i = 0; i < 3; i++) {
+            const T* axis = vertexes.data(i);
+            T axis_min = std::numeric_limits<T>::max(), axis_max = std::numeric_limits<T>::lowest();
+
+            for (size_t j = 0, n = vertexes.size(); j < n; j++) {
+                axis_min = std::min(axis_min, axis[j]);
+                axis_max = std::max(axis_max, axis[j]);
+            }
+
+            lower_bounds[i] = axis_min;
+            upper_bounds[i] = axis_max;
+        }
     }
 
+    // O(1), the box of the transformed object comes from its transformed local box
     template <class T>
-    typename static_object3d<T>::const_iterator static_object3d<T>::begin() const noexcept {
-        return relative_vertexes.begin();
+    void aabb3d<T>::update_bounds(const static_object3d<T>& object) {
+        *this = object.bounds();
     }
 
+    // center moves with the transform, extent grows by the absolute linear part,
+    // so the result encloses the transformed box but is not tight around the vertexes
     template <class T>
-    typename static_object3d<T>::iterator static_object3d<T>::end() noexcept {
-        return relative_vertexes.end();
+    aabb3d<T> aabb3d<T>::transformed(const affine3d<T>& transform) const {
+        const matrix3d<T>& linear = transform.linear();
+        const vector3d<T>& translation = transform.translation();
+
+        T center[3], extent[3];
+        for (size_t i = 0; i < 3; i++) {
+            center[i] = (lower_bounds[i] + upper_bounds[i]) / 2;
+            extent[i] = (upper_bounds[i] - lower_bounds[i]) / 2;
+        }
+
+        aabb3d<T> box;
+        for (size_t i = 0; i < 3; i++) {
+            T world_center = translation[i], world_extent = 0;
+
+            for (size_t j = 0; j < 3; j++) {
+                world_center += linear[i][j] * center[j];
+                world_extent += std::abs(linear[i][j]) * extent[j];
+            }
+
+            box.lower_bounds[i] = world_center - world_extent;
+            box.upper_bounds[i] = world_center + world_extent;
+        }
+        return box;
     }
 
     template <class T>
-    typename static_object3d<T>::const_iterator static_object3d<T>::end() const noexcept {
-        return relative_vertexes.end();
+    aabb3d<T> aabb3d<T>::merged(const aabb3d<T>& box) const {
+        aabb3d<T> result;
+        for (size_t i = 0; i < 3; i++) {
+            result.lower_bounds[i] = std::min(lower_bounds[i], box.lower_bounds[i]);
+            result.upper_bounds[i] = std::max(upper_bounds[i], box.upper_bounds[i]);
+        }
+        return result;
     }
 
     template <class T>
-    const std::vector<vector3d<T>>& static_object3d<T>::vertexes() const {
-        return relative_vertexes;
+    aabb3d<T> aabb3d<T>::expanded(T margin) const {
+        aabb3d<T> result;
+        for (size_t i = 0; i < 3; i++) {
+            result.lower_bounds[i] = lower_bounds[i] - margin;
+            result.upper_bounds[i] = upper_bounds[i] + margin;
+        }
+        return result;
     }
 
+    // true when the boxes overlap or touch
     template <class T>
-    const vector3d<T>& static_object3d<T>::origin() const {
-        return relative_origin;
+    bool aabb3d<T>::check_bounds(const aabb3d<T>& box) const {
+#if defined(__SSE__)
+        if constexpr (std::is_same<T, float>::value) {
+            __m128 below = _mm_cmple_ps(_mm_load_ps(lower_bounds), _mm_load_ps(box.upper_bounds));
+            __m128 above = _mm_cmple_ps(_mm_load_ps(box.lower_bounds), _mm_load_ps(upper_bounds));
+
+            return _mm_movemask_ps(_mm_and_ps(below, above)) == 0xF;
+        }
+#endif
+        bool overlap = true;
+        for (size_t i = 0; i < 4; i++)
+            overlap &= (lower_bounds[i] <= box.upper_bounds[i]) & (box.lower_bounds[i] <= upper_bounds[i]);
+        return overlap;
     }
 
     template <class T>
-    class aabb3d {
-    public:
-        explicit aabb3d(const static_object3d<T>& object) noexcept;
+    bool aabb3d<T>::contains(const aabb3d<T>& box) const {
+        bool inside = true;
+        for (size_t i = 0; i < 3; i++)
+            inside &= (lower_bounds[i] <= box.lower_bounds[i]) & (box.upper_bounds[i] <= upper_bounds[i]);
+        return inside;
+    }
 
-        void update_bounds(const std::vector<vector3d<T>>& vertexes);
-        void update_bounds(const static_object3d<T>& object);
+    // surface area, the cost measure of bounding volume hierarchies
+    template <class T>
+    T aabb3d<T>::area() const {
+        const T x = upper_bounds[0] - lower_bounds[0], y = upper_bounds[1] - lower_bounds[1], z = upper_bounds[2] - lower_bounds[2];
+        return 2 * (x * y + y * z + z * x);
+    }
 
-        bool check_bounds(const aabb3d<T>& box) const;
+    template <class T>
+    vector3d<T> aabb3d<T>::lower() const {
+        return vector3d<T>(lower_bounds[0], lower_bounds[1], lower_bounds[2]);
+    }
+
+    template <class T>
+    vector3d<T> aabb3d<T>::upper() const {
+        return vector3d<T>(upper_bounds[0], upper_bounds[1], upper_bounds[2]);
+    }
+
+    template <class T>
+    T aabb3d<T>::lower(size_t axis) const {
+        return lower_bounds[axis];
+    }
+
+    template <class T>
+    T aabb3d<T>::upper(size_t axis) const {
+        return upper_bounds[axis];
+    }
+
+    // immutable model data, shared between every object built from it
+    template <class T>
+    class mesh3d {
+    public:
+        mesh3d() = delete;
+        explicit mesh3d(const std::vector<vector3d<T>>& vertexes,
+                        const std::vector<std::vector<size_t>>& vertex_order = {});
+
+        const vertex_buffer3d<T>& vertexes() const;
+        const vector3d<T>& origin() const;
+        const aabb3d<T>& bounds() const;
+        const std::vector<std::vector<size_t>>& vertex_order() const;
 
     protected:
-        std::vector<std::pair<T, T>> bounds;
+        vertex_buffer3d<T> _vertexes;
+        vector3d<T> _origin;
+        aabb3d<T> _bounds;
+        std::vector<std::vector<size_t>> _vertex_order;
     };
 
     template <class T>
-    aabb3d<T>::aabb3d(const static_object3d<T>& object) noexcept
-            : bounds(3)
+    using shared_mesh3d = std::shared_ptr<const mesh3d<T>>;
+
+    template <class T>
+    mesh3d<T>::mesh3d(const std::vector<vector3d<T>>& vertexes,
+                      const std::vector<std::vector<size_t>>& vertex_order)
+        : _vertexes(vertexes),
+          _origin(0),
+          _bounds(_vertexes),
+          _vertex_order(vertex_order)
     {
-        update_bounds(object);
+        for (size_t i = 0; i < 3; i++) {
+            const T* axis = _vertexes.data(i);
+
+            for (size_t j = 0, n = _vertexes.size(); j < n; j++)
+                _origin[i] += axis[j];
+        }
+
+        _origin /= vertexes.size();
     }
 
     template <class T>
-    void aabb3d<T>::update_bounds(const std::vector<vector3d<T>>& vertexes) {
-        static constexpr T absolute_min = std::numeric_limits<T>::min(), absolute_max = std::numeric_limits<T>::max();
+    const vertex_buffer3d<T>& mesh3d<T>::vertexes() const {
+        return _vertexes;
+    }
 
-        for (size_t i = 0; i < bounds.size(); i++) {
-            bounds[i].first  = absolute_max;
-            bounds[i].second = absolute_min;
-        }
+    template <class T>
+    const vector3d<T>& mesh3d<T>::origin() const {
+        return _origin;
+    }
 
-        for (auto& vertex : vertexes) {
-            for (size_t i = 0; i < bounds.size(); i++) {
-                bounds[i].first  = std::min(bounds[i].first,  vertex[i]);
-                bounds[i].second = std::max(bounds[i].second, vertex[i]);
-            }
-        }
+    template <class T>
+    const aabb3d<T>& mesh3d<T>::bounds() const {
+        return _bounds;
     }
 
     template <class T>
-    void aabb3d<T>::update_bounds(const static_object3d<T>& object) {
-        update_bounds(object.vertexes());
+    const std::vector<std::vector<size_t>>& mesh3d<T>::vertex_order() const {
+        return _vertex_order;
     }
 
     template <class T>
-    bool aabb3d<T>::check_bounds(const aabb3d<T>& box) const {
-        for (size_t i = 0; i < bounds.size(); i++)
-            if (bounds[i].first  <= box.bounds[i].second &&
-                bounds[i].second >= box.bounds[i].first)
-                return false;
-        return true;
+    class static_object3d {
+    public:
+        using const_iterator = typename vertex_buffer3d<T>::const_iterator;
+        using iterator = const_iterator;
+
+        static_object3d() = delete;
+        static_object3d(const std::initializer_list<vector3d<T>>& vertexes);
+        explicit static_object3d(const std::vector<vector3d<T>>& vertexes);
+        explicit static_object3d(const shared_mesh3d<T>& mesh);
+        virtual ~static_object3d() = default;
+
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+
+        virtual const vertex_buffer3d<T>& vertexes() const;
+        virtual aabb3d<T> bounds() const;
+        const vector3d<T>& origin() const;
+
+        const shared_mesh3d<T>& mesh() const;
+
+    protected:
+        shared_mesh3d<T> _mesh;
+        vector3d<T> relative_origin;
+    };
+
+    template <class T>
+    static_object3d<T>::static_object3d(const std::initializer_list<vector3d<T>>& vertexes)
+        : static_object3d<T>::static_object3d(std::vector<vector3d<T>>(vertexes)) {}
+
+    template <class T>
+    static_object3d<T>::static_object3d(const std::vector<vector3d<T>>& vertexes)
+        : static_object3d<T>::static_object3d(std::make_shared<const mesh3d<T>>(vertexes)) {}
+
+    template <class T>
+    static_object3d<T>::static_object3d(const shared_mesh3d<T>& mesh)
+        : _mesh(mesh),
+          relative_origin(mesh->origin()) {}
+
+    template <class T>
+    typename static_object3d<T>::const_iterator static_object3d<T>::begin() const noexcept {
+        return vertexes().begin();
+    }
+
+    template <class T>
+    typename static_object3d<T>::const_iterator static_object3d<T>::end() const noexcept {
+        return vertexes().end();
+    }
+
+    template <class T>
+    const vertex_buffer3d<T>& static_object3d<T>::vertexes() const {
+        return _mesh->vertexes();
+    }
+
+    template <class T>
+    aabb3d<T> static_object3d<T>::bounds() const {
+        return _mesh->bounds();
+    }
+
+    template <class T>
+    const vector3d<T>& static_object3d<T>::origin() const {
+        return relative_origin;
+    }
+
+    template <class T>
+    const shared_mesh3d<T>& static_object3d<T>::mesh() const {
+        return _mesh;
     }
 
     template <class T>
@@ -171,26 +365,148 @@ namespace object {
         return vector3d<T>(this->scalars[3], this->scalars[4], this->scalars[5]);
     }
 
+    // paths a sequence takes through its step, all of them start at zero and end on the whole step,
+    // held by value in a variant so sequences copy without allocating and substeps dispatch without type erasure
     template <class T>
-    using substep_constructor3d = std::function<step3d<T>(size_t)>;
+    class linear_interpolator3d {
+    public:
+        linear_interpolator3d() = delete;
+        explicit linear_interpolator3d(const step3d<T>& step) noexcept;
+
+        step3d<T> operator()(T fraction) const;
+        step3d<T> operator()(T from, T to) const;
+
+        linear_interpolator3d<T> restricted(T fraction) const;
+
+    protected:
+        step3d<T> step;
+    };
 
     template <class T>
-    static substep_constructor3d<T> linear_substep_constructor(const step3d<T>& step, size_t step_count) {
-        return [=](size_t) { return step / step_count; };
+    linear_interpolator3d<T>::linear_interpolator3d(const step3d<T>& step) noexcept
+        : step(step) {}
+
+    template <class T>
+    step3d<T> linear_interpolator3d<T>::operator()(T fraction) const {
+        return step * fraction;
+    }
+
+    // offset between two fractions
+    template <class T>
+    step3d<T> linear_interpolator3d<T>::operator()(T from, T to) const {
+        return step * (to - from);
+    }
+
+    // the path up to fraction, stretched over the whole of [0, 1]
+    template <class T>
+    linear_interpolator3d<T> linear_interpolator3d<T>::restricted(T fraction) const {
+        return linear_interpolator3d<T>(step * fraction);
+    }
+
+    // cubic from zero to the step leaving and arriving along the given tangents, kept as polynomial coefficients
+    template <class T>
+    class hermite_interpolator3d {
+    public:
+        hermite_interpolator3d() = delete;
+        explicit hermite_interpolator3d(const step3d<T>& step, const step3d<T>& start_tangent, const step3d<T>& stop_tangent) noexcept;
+
+        step3d<T> operator()(T fraction) const;
+        step3d<T> operator()(T from, T to) const;
+
+        hermite_interpolator3d<T> restricted(T fraction) const;
+
+    protected:
+        step3d<T> linear;
+        step3d<T> quadratic;
+        step3d<T> cubic;
+    };
+
+    template <class T>
+    hermite_interpolator3d<T>::hermite_interpolator3d(const step3d<T>& step, const step3d<T>& start_tangent,
+                                                      const step3d<T>& stop_tangent) noexcept
+        : linear(start_tangent),
+          quadratic(step * 3 - start_tangent * 2 - stop_tangent),
+          cubic(start_tangent + stop_tangent - step * 2) {}
+
+    template <class T>
+    step3d<T> hermite_interpolator3d<T>::operator()(T fraction) const {
+        step3d<T> result = cubic * fraction;
+        result += quadratic;
+        result *= fraction;
+        result += linear;
+        return result *= fraction;
+    }
+
+    template <class T>
+    step3d<T> hermite_interpolator3d<T>::operator()(T from, T to) const {
+        step3d<T> result = operator()(to);
+        return result -= operator()(from);
+    }
+
+    // the same cubic up to fraction, stretched over [0, 1], which scales its tangents by fraction
+    template <class T>
+    hermite_interpolator3d<T> hermite_interpolator3d<T>::restricted(T fraction) const {
+        step3d<T> stop_tangent = cubic * (3 * fraction);
+        stop_tangent += quadratic * 2;
+        stop_tangent *= fraction;
+        stop_tangent += linear;
+
+        return hermite_interpolator3d<T>(operator()(fraction), linear * fraction, stop_tangent * fraction);
+    }
+
+    // hermite with the uniform catmull-rom tangents through the steps before and after,
+    // so consecutive sequences join without a kink
+    template <class T>
+    class catmull_rom_interpolator3d : public hermite_interpolator3d<T> {
+    public:
+        catmull_rom_interpolator3d() = delete;
+        explicit catmull_rom_interpolator3d(const step3d<T>& before, const step3d<T>& step, const step3d<T>& after) noexcept;
+    };
+
+    template <class T>
+    catmull_rom_interpolator3d<T>::catmull_rom_interpolator3d(const step3d<T>& before, const step3d<T>& step,
+                                                              const step3d<T>& after) noexcept
+        : hermite_interpolator3d<T>::hermite_interpolator3d(step, (before + step) / 2, (step + after) / 2) {}
+
+    template <class T>
+    using substep_interpolator3d = std::variant<linear_interpolator3d<T>, hermite_interpolator3d<T>, catmull_rom_interpolator3d<T>>;
+
+    // timing of a sequence, the interpolator is evaluated at the eased fraction of its substeps
+    typedef enum : unsigned char {
+        UNIFORM, EASE_IN, EASE_OUT, EASE_IN_OUT
+    } substep_easing;
+
+    template <class T>
+    T ease(substep_easing easing, T fraction) {
+        switch (easing) {
+            case EASE_IN:
+                return fraction * fraction;
+            case EASE_OUT:
+                return fraction * (2 - fraction);
+            case EASE_IN_OUT:
+                return fraction * fraction * (3 - 2 * fraction);
+            default:
+                return fraction;
+        }
     }
 
     typedef enum : unsigned char {
         START, NONE, STOP
     } stage;
 
+    // INCREMENTAL follows the SLERP path by composing a per substep delta computed once per sequence
+    typedef enum : unsigned char {
+        EULER, SLERP, INCREMENTAL
+    } rotation_interpolation;
+
     template <class T>
     class sequence3d {
     public:
         sequence3d() = delete;
         explicit sequence3d(const step3d<T>& step, size_t step_count,
-                            const substep_constructor3d<T>& next_constructor,
-                            const substep_constructor3d<T>& previous_constructor) noexcept;
-        explicit sequence3d(const step3d<T>& step, size_t step_count) noexcept;
+                            rotation_interpolation interpolation = EULER, substep_easing easing = UNIFORM) noexcept;
+        explicit sequence3d(const substep_interpolator3d<T>& interpolator, size_t step_count,
+                            rotation_interpolation interpolation = EULER, substep_easing easing = UNIFORM) noexcept;
 
         std::pair<stage, step3d<T>> next_substep();
         std::pair<stage, step3d<T>> previous_substep();
@@ -198,49 +514,74 @@ namespace object {
         const step3d<T>& next_step() const;
         const step3d<T>& previous_step() const;
 
+        rotation_interpolation interpolation() const;
+        substep_easing easing() const;
+        size_t substeps() const;
+        T progress() const;
+
+        void rewind();
+        void finish();
+
+        sequence3d<T> truncated(T fraction) const;
+
     protected:
-        const size_t start_substep;
+        T fraction(size_t substep) const;
+        step3d<T> offset(size_t from, size_t to) const;
+
+        // substeps taken, 0 before the first and stop_substep once the sequence stopped,
+        // both directions move it by one so a reversal retraces the substep just taken
         const size_t stop_substep;
-        size_t current_substep;
+        size_t position;
+
+        rotation_interpolation _interpolation;
+        substep_easing _easing;
+
+        substep_interpolator3d<T> interpolator;
+        T substep_fraction;
 
         // TODO reconsider naming
         step3d<T> _next_step;
         step3d<T> _previous_step;
-
-        substep_constructor3d<T> next_constructor;
-        substep_constructor3d<T> previous_constructor;
     };
 
-    // TODO reconsider reusing constructor
     template <class T>
     sequence3d<T>::sequence3d(const step3d<T>& step, size_t step_count,
-                              const substep_constructor3d<T>& next_constructor,
-                              const substep_constructor3d<T>& previous_constructor) noexcept
-            : start_substep(1), stop_substep(step_count), current_substep(start_substep),
-              _next_step(step), _previous_step(step * (-1)),
-              next_constructor(next_constructor), previous_constructor(previous_constructor) {}
+                              rotation_interpolation interpolation, substep_easing easing) noexcept
+            : sequence3d<T>::sequence3d(linear_interpolator3d<T>(step), step_count, interpolation, easing) {}
 
     template <class T>
-    sequence3d<T>::sequence3d(const step3d<T>& step, size_t step_count) noexcept
-            :start_substep(1), stop_substep(step_count), current_substep(start_substep),
-              _next_step(step), _previous_step(step * (-1)),
-              next_constructor(linear_substep_constructor(_next_step, step_count)),
-              previous_constructor(linear_substep_constructor(_previous_step, step_count)) {}
+    sequence3d<T>::sequence3d(const substep_interpolator3d<T>& interpolator, size_t step_count,
+                              rotation_interpolation interpolation, substep_easing easing) noexcept
+            : stop_substep(step_count), position(0),
+              _interpolation(interpolation), _easing(easing), interpolator(interpolator),
+              substep_fraction(static_cast<T>(1) / step_count),
+              _next_step(std::visit([](const auto& path) { return path(static_cast<T>(1)); }, interpolator)),
+              _previous_step(_next_step * (-1)) {}
 
     template <class T>
     std::pair<stage, step3d<T>> sequence3d<T>::next_substep() {
-        if (current_substep >= stop_substep)
+        if (position + 1 >= stop_substep) {
+            position = stop_substep;
             return std::pair(STOP, _next_step);
+        }
 
-        return std::pair(current_substep <= start_substep ? START : NONE, next_constructor(current_substep++));
+        stage substep_stage = position == 0 ? START : NONE;
+        position++;
+
+        return std::pair(substep_stage, offset(position - 1, position));
     }
 
     template <class T>
     std::pair<stage, step3d<T>> sequence3d<T>::previous_substep() {
-        if (current_substep <= start_substep)
+        if (position <= 1) {
+            position = 0;
             return std::pair(STOP, _previous_step);
+        }
+
+        stage substep_stage = position == stop_substep ? START : NONE;
+        position--;
 
-        return std::pair(current_substep >= stop_substep ? START : NONE, previous_constructor(--current_substep));
+        return std::pair(substep_stage, offset(position + 1, position));
     }
 
     template <class T>
@@ -253,12 +594,79 @@ namespace object {
         return _previous_step;
     }
 
+    template <class T>
+    rotation_interpolation sequence3d<T>::interpolation() const {
+        return _interpolation;
+    }
+
+    template <class T>
+    substep_easing sequence3d<T>::easing() const {
+        return _easing;
+    }
+
+    template <class T>
+    size_t sequence3d<T>::substeps() const {
+        return stop_substep;
+    }
+
+    // eased fraction of the step reached by the last returned substep
+    template <class T>
+    T sequence3d<T>::progress() const {
+        return fraction(position);
+    }
+
+    // back to before the first substep, as the sequence was constructed
+    template <class T>
+    void sequence3d<T>::rewind() {
+        position = 0;
+    }
+
+    // as left after stepping through to STOP
+    template <class T>
+    void sequence3d<T>::finish() {
+        position = stop_substep;
+    }
+
+    // the path up to fraction of the last substep taken, over as many substeps as were taken, returned finished,
+    // substeps are spread anew over the shorter path, its shape and rotation interpolation are kept
+    template <class T>
+    sequence3d<T> sequence3d<T>::truncated(T fraction) const {
+        const T cut = ease(_easing, (static_cast<T>(position - 1) + std::clamp(fraction, T(0), T(1))) * substep_fraction);
+
+        sequence3d<T> sequence(std::visit([cut](const auto& path) { return substep_interpolator3d<T>(path.restricted(cut)); }, interpolator),
+                               position, _interpolation, _easing);
+        sequence.finish();
+        return sequence;
+    }
+
+    template <class T>
+    T sequence3d<T>::fraction(size_t substep) const {
+        return ease(_easing, substep * substep_fraction);
+    }
+
+    // offset along the step between the positions after two substeps
+    template <class T>
+    step3d<T> sequence3d<T>::offset(size_t from, size_t to) const {
+        const T start = fraction(from), stop = fraction(to);
+
+        // switched by hand, std::visit goes through a table of function pointers gcc does not inline
+        switch (interpolator.index()) {
+            case 0:
+                return (*std::get_if<0>(&interpolator))(start, stop);
+            case 1:
+                return (*std::get_if<1>(&interpolator))(start, stop);
+            default:
+                return (*std::get_if<2>(&interpolator))(start, stop);
+        }
+    }
+
     template <class T>
     class dynamic_object3d : public static_object3d<T> {
     public:
         dynamic_object3d() = delete;
         dynamic_object3d(const std::initializer_list<vector3d<T>>& vertexes);
         explicit dynamic_object3d(const std::vector<vector3d<T>>& vertexes);
+        explicit dynamic_object3d(const shared_mesh3d<T>& mesh);
 
         void translate_absolute(const vector3d<T>& translation);
 
@@ -267,19 +675,39 @@ namespace object {
 
         void rotate(const vector3d<T>& rotation, const vector3d<T>& point);
         void rotate(const vector3d<T>& rotation);
+        void rotate(const quaternion<T>& rotation);
+
+        void orient(const quaternion<T>& orientation);
+        void place(const vector3d<T>& translation, const quaternion<T>& orientation);
 
         void step(const step3d<T>& step);
         void update();
 
+        const vertex_buffer3d<T>& vertexes() const override;
+        aabb3d<T> bounds() const override;
+
         const vector3d<T>& translation() const;
         const vector3d<T>& rotation() const;
+        const quaternion<T>& orientation() const;
+        const affine3d<T>& pose() const;
 
     protected:
-        std::vector<vector3d<T>> absolute_vertexes;
-        vector3d<T> absolute_origin;
+        void reset(const vector3d<T>& translation, const vector3d<T>& rotation);
+        void materialize() const;
 
         vector3d<T> relative_translation;
         vector3d<T> relative_rotation;
+
+        // drives update(), kept in sync with relative_rotation which stays the euler view of it
+        quaternion<T> relative_orientation;
+
+        // mesh vertexes to relative_vertexes in one pass, rebuilt by update(),
+        // which only marks the vertexes dirty, they are transformed once when next read
+        affine3d<T> relative_pose;
+
+        // written by the first read after a move without synchronization, see vertexes()
+        mutable vertex_buffer3d<T> relative_vertexes; // allocated on the first read
+        mutable bool dirty;
     };
 
     template <class T>
@@ -288,20 +716,21 @@ namespace object {
 
     template <class T>
     dynamic_object3d<T>::dynamic_object3d(const std::vector<vector3d<T>>& vertexes)
-         : static_object3d<T>::static_object3d(vertexes),
-           absolute_vertexes(this->relative_vertexes),
-           absolute_origin(this->relative_origin),
+         : dynamic_object3d<T>::dynamic_object3d(std::make_shared<const mesh3d<T>>(vertexes)) {}
+
+    template <class T>
+    dynamic_object3d<T>::dynamic_object3d(const shared_mesh3d<T>& mesh)
+         : static_object3d<T>::static_object3d(mesh),
            relative_translation(0),
-           relative_rotation(0) {}
+           relative_rotation(0),
+           relative_orientation(quaternion<T>::identity()),
+           relative_pose(affine3d<T>::identity()),
+           dirty(true) {}
 
     template <class T>
     void dynamic_object3d<T>::translate_absolute(const vector3d<T>& translation) {
         relative_translation += translation;
-
-        for (auto& vertex : this->relative_vertexes)
-            vertex += translation;
-
-        this->relative_origin += translation;
+        update();
     }
 
     template <class T>
@@ -312,15 +741,34 @@ namespace object {
 
     template <class T>
     void dynamic_object3d<T>::translate_relative(const vector3d<T>& translation) {
-        translate_relative(translation, relative_rotation);
+        translate_absolute(relative_orientation * translation);
     }
 
     template <class T>
     void dynamic_object3d<T>::rotate(const vector3d<T>& rotation) {
         relative_rotation += rotation;
+        relative_orientation = quaternion<T>::rotation_degrees(relative_rotation);
+        update();
+    }
+
+    template <class T>
+    void dynamic_object3d<T>::rotate(const quaternion<T>& rotation) {
+        orient(rotation * relative_orientation);
+    }
+
+    template <class T>
+    void dynamic_object3d<T>::orient(const quaternion<T>& orientation) {
+        relative_orientation = orientation.normalized();
+        relative_rotation = relative_orientation.degrees();
         update();
     }
 
+    template <class T>
+    void dynamic_object3d<T>::place(const vector3d<T>& translation, const quaternion<T>& orientation) {
+        relative_translation = translation;
+        orient(orientation);
+    }
+
     template <class T>
     void dynamic_object3d<T>::rotate(const vector3d<T>& rotation, const vector3d<T>& point) {
         vector3d<T> new_origin = this->relative_origin;
@@ -336,23 +784,46 @@ namespace object {
     void dynamic_object3d<T>::step(const object::step3d<T>& step) {
         relative_translation += step.translation();
         relative_rotation += step.rotation();
+        relative_orientation = quaternion<T>::rotation_degrees(relative_rotation);
+        update();
+    }
+
+    template <class T>
+    void dynamic_object3d<T>::reset(const vector3d<T>& translation, const vector3d<T>& rotation) {
+        relative_translation = translation;
+        relative_rotation = rotation;
+        relative_orientation = quaternion<T>::rotation_degrees(relative_rotation);
         update();
     }
 
     template <class T>
     void dynamic_object3d<T>::update() {
-        this->relative_vertexes = absolute_vertexes;
-        this->relative_origin = absolute_origin;
+        const vector3d<T>& absolute_origin = this->_mesh->origin();
+        this->relative_origin = absolute_origin + relative_translation;
 
-        for (auto& vertex : this->relative_vertexes)
-            vertex += relative_translation;
+        relative_pose = affine3d<T>::translating(relative_translation) * affine3d<T>::rotating(relative_orientation, absolute_origin);
+        dirty = true;
+    }
 
-        this->relative_origin += relative_translation;
+    template <class T>
+    void dynamic_object3d<T>::materialize() const {
+        relative_pose.apply(this->_mesh->vertexes(), relative_vertexes);
+        dirty = false;
+    }
 
-        matrix3d<T> rotation = matrix3d<T>::rotation_degrees(relative_rotation);
+    // the first read after a move transforms the vertexes into a cache, so it must not race another read,
+    // threads sharing an object read it once first, e.g. in the pass that moved it as parallel_step does,
+    // after which concurrent reads are safe until the next move, bounds() never touches the cache
+    template <class T>
+    const vertex_buffer3d<T>& dynamic_object3d<T>::vertexes() const {
+        if (dirty)
+            materialize();
+        return relative_vertexes;
+    }
 
-        for (auto& vertex : this->relative_vertexes)
-            vertex.rotate(this->relative_origin, rotation);
+    template <class T>
+    aabb3d<T> dynamic_object3d<T>::bounds() const {
+        return this->_mesh->bounds().transformed(relative_pose);
     }
 
     template <class T>
@@ -365,27 +836,249 @@ namespace object {
         return relative_rotation;
     }
 
+    template <class T>
+    const quaternion<T>& dynamic_object3d<T>::orientation() const {
+        return relative_orientation;
+    }
+
+    template <class T>
+    const affine3d<T>& dynamic_object3d<T>::pose() const {
+        return relative_pose;
+    }
+
+    // poses an object3d passes through over all its sequences, frame 0 being before the first substep,
+    // any frame is read directly instead of substepping to it and frames are never written after baking,
+    // so several threads may evaluate them at once
+    template <class T>
+    class trajectory3d {
+    public:
+        trajectory3d() = delete;
+        explicit trajectory3d(const shared_mesh3d<T>& mesh) noexcept;
+
+        void reserve(size_t frames);
+        void push_back(const dynamic_object3d<T>& object);
+
+        size_t size() const;
+
+        const vector3d<T>& translation(size_t frame) const;
+        const quaternion<T>& orientation(size_t frame) const;
+
+        affine3d<T> pose(size_t frame) const;
+        void vertexes(size_t frame, vertex_buffer3d<T>& destination) const;
+
+        void seek(dynamic_object3d<T>& object, size_t frame) const;
+
+    protected:
+        shared_mesh3d<T> mesh;
+
+        std::vector<vector3d<T>> translations;
+        std::vector<quaternion<T>> orientations;
+    };
+
+    template <class T>
+    trajectory3d<T>::trajectory3d(const shared_mesh3d<T>& mesh) noexcept
+        : mesh(mesh) {}
+
+    template <class T>
+    void trajectory3d<T>::reserve(size_t frames) {
+        translations.reserve(frames);
+        orientations.reserve(frames);
+    }
+
+    template <class T>
+    void trajectory3d<T>::push_back(const dynamic_object3d<T>& object) {
+        translations.push_back(object.translation());
+        orientations.push_back(object.orientation());
+    }
+
+    template <class T>
+    size_t trajectory3d<T>::size() const {
+        return translations.size();
+    }
+
+    template <class T>
+    const vector3d<T>& trajectory3d<T>::translation(size_t frame) const {
+        return translations[frame];
+    }
+
+    template <class T>
+    const quaternion<T>& trajectory3d<T>::orientation(size_t frame) const {
+        return orientations[frame];
+    }
+
+    // the pose dynamic_object3d::update() builds for the frame
+    template <class T>
+    affine3d<T> trajectory3d<T>::pose(size_t frame) const {
+        return affine3d<T>::translating(translations[frame]) * affine3d<T>::rotating(orientations[frame], mesh->origin());
+    }
+
+    template <class T>
+    void trajectory3d<T>::vertexes(size_t frame, vertex_buffer3d<T>& destination) const {
+        pose(frame).apply(mesh->vertexes(), destination);
+    }
+
+    // places the object with a single update, an object3d keeps its own sequences where they were
+    template <class T>
+    void trajectory3d<T>::seek(dynamic_object3d<T>& object, size_t frame) const {
+        object.place(translations[frame], orientations[frame]);
+    }
+
+    // contiguous ring of sequences, only written at its ends and grown by doubling,
+    // sequences are constructed in their slots and moved when it grows, never copied between queues
+    template <class T>
+    class sequence_ring3d {
+    public:
+        void push_back(const sequence3d<T>& sequence);
+        void push_back(sequence3d<T>&& sequence);
+        void pop_front();
+        void replace(size_t index, sequence3d<T>&& sequence);
+
+        sequence3d<T>& operator[](size_t index);
+        const sequence3d<T>& operator[](size_t index) const;
+
+        size_t size() const;
+        bool empty() const;
+
+        void reserve(size_t size);
+
+    protected:
+        template <class S>
+        void emplace_back(S&& sequence);
+
+        size_t slot(size_t index) const;
+
+        std::vector<std::optional<sequence3d<T>>> slots;
+        size_t head = 0;
+        size_t count = 0;
+    };
+
+    template <class T>
+    void sequence_ring3d<T>::push_back(const sequence3d<T>& sequence) {
+        emplace_back(sequence);
+    }
+
+    template <class T>
+    void sequence_ring3d<T>::push_back(sequence3d<T>&& sequence) {
+        emplace_back(std::move(sequence));
+    }
+
+    template <class T>
+    void sequence_ring3d<T>::pop_front() {
+        slots[head].reset();
+        head = slot(1);
+        count--;
+    }
+
+    template <class T>
+    void sequence_ring3d<T>::replace(size_t index, sequence3d<T>&& sequence) {
+        slots[slot(index)].emplace(std::move(sequence));
+    }
+
+    template <class T>
+    sequence3d<T>& sequence_ring3d<T>::operator[](size_t index) {
+        return *slots[slot(index)];
+    }
+
+    template <class T>
+    const sequence3d<T>& sequence_ring3d<T>::operator[](size_t index) const {
+        return *slots[slot(index)];
+    }
+
+    template <class T>
+    size_t sequence_ring3d<T>::size() const {
+        return count;
+    }
+
+    template <class T>
+    bool sequence_ring3d<T>::empty() const {
+        return count == 0;
+    }
+
+    template <class T>
+    void sequence_ring3d<T>::reserve(size_t size) {
+        if (size <= slots.size())
+            return;
+
+        std::vector<std::optional<sequence3d<T>>> grown(size);
+
+        for (size_t i = 0; i < count; i++)
+            grown[i].emplace(std::move(*slots[slot(i)]));
+
+        slots = std::move(grown);
+        head = 0;
+    }
+
+    template <class T>
+    template <class S>
+    void sequence_ring3d<T>::emplace_back(S&& sequence) {
+        if (count == slots.size())
+            reserve(std::max<size_t>(8, 2 * slots.size()));
+
+        slots[slot(count)].emplace(std::forward<S>(sequence));
+        count++;
+    }
+
+    template <class T>
+    size_t sequence_ring3d<T>::slot(size_t index) const {
+        index += head;
+        return index < slots.size() ? index : index - slots.size();
+    }
+
     template <class T>
     class object3d : public dynamic_object3d<T> {
     public:
         object3d() = delete;
         object3d(const std::initializer_list<vector3d<T>>& vertexes);
         explicit object3d(const std::vector<vector3d<T>>& vertexes);
+        explicit object3d(const shared_mesh3d<T>& mesh);
 
         void next_sequence(const sequence3d<T>& sequence);
+        void next_sequence(sequence3d<T>&& sequence);
+
+        void limit_history(size_t sequences);
+        void checkpoint_every(size_t sequences);
+
+        trajectory3d<T> bake() const;
 
         bool next_substep();
         bool previous_substep();
 
+        void rewind(size_t sequence, size_t substeps = 0);
+        void truncate(T fraction);
+
     protected:
+        // incremental orientation is snapped back onto the exact slerp this often, which bounds its drift
+        static constexpr size_t reanchor_substeps = 32;
+
+        void start_substeps(bool reverse);
+        void substep(const step3d<T>& substep, bool reverse);
+
+        void drop_oldest();
+        void checkpoint(size_t index, const step3d<T>& start);
+
         vector3d<T> partial_relative_translation;
         vector3d<T> partial_relative_rotation;
 
-        // TODO consider sequence holder thing and make_unique thing, or could be just one list with pointer
-        std::list<sequence3d<T>> next_sequences;
-        std::list<sequence3d<T>> previous_sequences;
+        quaternion<T> start_orientation;
+        quaternion<T> stop_orientation;
+
+        quaternion<T> delta_orientation;
+        quaternion<T> incremental_orientation;
+        size_t incremental_substeps;
+        bool incremental_reverse;
+
+        // finished sequences before the cursor, the current or next one at it and pending ones after it
+        sequence_ring3d<T> sequences;
+        size_t cursor;
+        bool active; // the sequence at the cursor is partway through
 
-        std::unique_ptr<sequence3d<T>> current_sequence;
+        size_t history_limit;
+
+        // start poses of every checkpoint_interval-th sequence, numbered from the first one ever queued,
+        // the oldest is kept at the oldest sequence still retained
+        std::deque<std::pair<size_t, step3d<T>>> checkpoints;
+        size_t checkpoint_interval;
+        size_t dropped;
     };
 
     template <class T>
@@ -394,80 +1087,319 @@ namespace object {
 
     template <class T>
     object3d<T>::object3d(const std::vector<vector3d<T>>& vertexes)
-        : dynamic_object3d<T>::dynamic_object3d(vertexes),
+        : object3d<T>::object3d(std::make_shared<const mesh3d<T>>(vertexes)) {}
+
+    template <class T>
+    object3d<T>::object3d(const shared_mesh3d<T>& mesh)
+        : dynamic_object3d<T>::dynamic_object3d(mesh),
           partial_relative_translation(this->relative_translation),
           partial_relative_rotation(this->relative_rotation),
-          current_sequence(nullptr) {}
+          incremental_substeps(0),
+          incremental_reverse(false),
+          cursor(0),
+          active(false),
+          history_limit(std::numeric_limits<size_t>::max()),
+          checkpoint_interval(16),
+          dropped(0) {}
 
     template <class T>
     void object3d<T>::next_sequence(const object::sequence3d<T>& sequence) {
-        next_sequences.push_back(sequence);
+        sequences.push_back(sequence);
+    }
+
+    template <class T>
+    void object3d<T>::next_sequence(object::sequence3d<T>&& sequence) {
+        sequences.push_back(std::move(sequence));
+    }
+
+    // finished sequences beyond the limit are dropped oldest first, previous_substep stops at the oldest kept
+    template <class T>
+    void object3d<T>::limit_history(size_t sequences) {
+        history_limit = sequences;
+    }
+
+    // rewind sums at most this many whole steps on top of a checkpoint, fewer cost memory instead
+    template <class T>
+    void object3d<T>::checkpoint_every(size_t sequences) {
+        checkpoint_interval = std::max<size_t>(sequences, 1);
+    }
+
+    // replays every sequence, past and pending, from where the first one started on a scratch object
+    template <class T>
+    trajectory3d<T> object3d<T>::bake() const {
+        object3d<T> replay(this->_mesh);
+        vector3d<T> translation = partial_relative_translation;
+        vector3d<T> rotation = partial_relative_rotation;
+
+        for (size_t i = 0; i < cursor; i++) {
+            translation -= sequences[i].next_step().translation();
+            rotation -= sequences[i].next_step().rotation();
+        }
+
+        replay.reset(translation, rotation);
+        replay.partial_relative_translation = translation;
+        replay.partial_relative_rotation = rotation;
+
+        size_t frames = 1;
+        replay.sequences.reserve(sequences.size());
+
+        for (size_t i = 0; i < sequences.size(); i++) {
+            replay.next_sequence(sequences[i]);
+            replay.sequences[i].rewind();
+            frames += sequences[i].substeps();
+        }
+
+        trajectory3d<T> trajectory(this->_mesh);
+        trajectory.reserve(frames);
+        trajectory.push_back(replay);
+
+        if (!replay.sequences.empty()) {
+            bool more;
+            do {
+                more = replay.next_substep();
+                trajectory.push_back(replay);
+            } while (more);
+        }
+        return trajectory;
     }
 
     template <class T>
     bool object3d<T>::next_substep() {
-        if (current_sequence == nullptr) {
-            if (next_sequences.empty())
+        if (!active) {
+            if (cursor == sequences.size())
                 return false;
+            active = true;
 
-            current_sequence = std::make_unique<sequence3d<T>>(next_sequences.front());
-            next_sequences.pop_front();
+            // the object may have been moved by rotate, orient or place since the last sequence stopped
+            partial_relative_translation = this->relative_translation;
+            partial_relative_rotation = this->relative_rotation;
+
+            const size_t index = dropped + cursor;
+            if (checkpoints.empty() || index % checkpoint_interval == 0)
+                checkpoint(index, step3d<T>(partial_relative_translation, partial_relative_rotation));
         }
 
-        auto [stage, substep] = current_sequence->next_substep();
+        auto [stage, substep] = sequences[cursor].next_substep();
 
         if (stage == STOP) {
-            step3d<T> step = current_sequence->next_step();
-            this->relative_translation = partial_relative_translation + step.translation();
-            this->relative_rotation = partial_relative_rotation + step.rotation();
-            this->update();
+            step3d<T> step = sequences[cursor].next_step();
+            this->reset(partial_relative_translation + step.translation(), partial_relative_rotation + step.rotation());
 
             partial_relative_translation = this->relative_translation;
             partial_relative_rotation = this->relative_rotation;
 
-            previous_sequences.push_back(*current_sequence);
-            current_sequence = nullptr;
+            active = false;
+            cursor++;
+
+            for (; cursor > history_limit; cursor--)
+                drop_oldest();
 
-            return !next_sequences.empty();
+            return cursor < sequences.size();
         }
 
-        this->step(substep);
+        if (stage == START)
+            start_substeps(false);
+
+        this->substep(substep, false);
         return true;
     }
 
     template <class T>
     bool object3d<T>::previous_substep() {
-        if (current_sequence == nullptr) {
-            if (previous_sequences.empty())
-                return false;
+        bool entering = false;
 
-            current_sequence = std::make_unique<sequence3d<T>>(previous_sequences.back());
-            previous_sequences.pop_back();
+        if (!active) {
+            if (cursor == 0)
+                return false;
+            cursor--;
+            active = true;
+            entering = true;
         }
 
-        auto [stage, substep] = current_sequence->previous_substep();
+        auto [stage, substep] = sequences[cursor].previous_substep();
 
         if (stage == STOP) {
-            this->relative_translation = partial_relative_translation;
-            this->relative_rotation = partial_relative_rotation;
-            this->update();
+            // a one substep sequence stops straight from its end, without the START that finds its start pose
+            if (entering) {
+                partial_relative_translation = this->relative_translation + substep.translation();
+                partial_relative_rotation = this->relative_rotation + substep.rotation();
+            }
 
-            next_sequences.push_front(*current_sequence);
-            current_sequence = nullptr;
+            this->reset(partial_relative_translation, partial_relative_rotation);
+            active = false;
 
-            return !previous_sequences.empty();
+            return cursor > 0;
         }
 
         if (stage == START) {
-            step3d<T> step = current_sequence->previous_step();
+            step3d<T> step = sequences[cursor].previous_step();
             partial_relative_translation = this->relative_translation + step.translation();
             partial_relative_rotation = this->relative_rotation + step.rotation();
+
+            start_substeps(true);
         }
 
-        this->step(substep);
+        this->substep(substep, true);
         return true;
     }
 
+    // restores the start of a retained sequence from the nearest checkpoint before it, then substeps into it,
+    // sequences count from the oldest retained and the substeps stop at its end
+    template <class T>
+    void object3d<T>::rewind(size_t sequence, size_t substeps) {
+        sequence = std::min(sequence, sequences.size());
+
+        if (checkpoints.empty())
+            checkpoints.emplace_back(dropped + cursor, step3d<T>(partial_relative_translation, partial_relative_rotation));
+
+        auto after = std::upper_bound(checkpoints.begin(), checkpoints.end(), dropped + sequence,
+                                      [](size_t index, const auto& checkpoint) { return index < checkpoint.first; });
+
+        const size_t index = std::prev(after)->first;
+        step3d<T> pose = std::prev(after)->second;
+
+        // the multiples summed over are recorded on the way, the checkpoint at index is not moved by it
+        for (size_t i = index - dropped; i < sequence; i++) {
+            pose += sequences[i].next_step();
+
+            if ((dropped + i + 1) % checkpoint_interval == 0)
+                checkpoint(dropped + i + 1, pose);
+        }
+
+        for (size_t i = sequence; i < std::min(cursor + 1, sequences.size()); i++)
+            sequences[i].rewind();
+        for (size_t i = cursor; i < sequence; i++)
+            sequences[i].finish();
+
+        partial_relative_translation = pose.translation();
+        partial_relative_rotation = pose.rotation();
+        this->reset(partial_relative_translation, partial_relative_rotation);
+
+        cursor = sequence;
+        active = false;
+
+        // counted from the first sequence ever queued, finishing it can drop the oldest and shift the cursor back onto it
+        const size_t target = dropped + sequence;
+        for (size_t i = 0; i < substeps && dropped + cursor == target; i++)
+            if (!next_substep())
+                break;
+    }
+
+    // cuts the sequence the last next_substep moved in at fraction of that substep, such as a time of impact,
+    // the object stops there and the pending sequences go on from there
+    template <class T>
+    void object3d<T>::truncate(T fraction) {
+        if (!active && cursor == 0)
+            return;
+
+        // a substep that stopped its sequence already moved the cursor past it
+        const size_t current = active ? cursor : cursor - 1;
+        const step3d<T>& step = sequences[current].next_step();
+
+        const vector3d<T> start_translation = active ? partial_relative_translation : vector3d<T>(partial_relative_translation - step.translation());
+        const vector3d<T> start_rotation = active ? partial_relative_rotation : vector3d<T>(partial_relative_rotation - step.rotation());
+
+        sequences.replace(current, sequences[current].truncated(fraction));
+
+        // the start poses recorded after it were summed over the whole step
+        checkpoints.erase(std::upper_bound(checkpoints.begin(), checkpoints.end(), dropped + current,
+                                           [](size_t index, const auto& checkpoint) { return index < checkpoint.first; }),
+                          checkpoints.end());
+
+        const step3d<T>& truncated = sequences[current].next_step();
+        this->reset(vector3d<T>(start_translation + truncated.translation()), vector3d<T>(start_rotation + truncated.rotation()));
+
+        partial_relative_translation = this->relative_translation;
+        partial_relative_rotation = this->relative_rotation;
+
+        active = false;
+        cursor = current + 1;
+
+        for (; cursor > history_limit; cursor--)
+            drop_oldest();
+    }
+
+    template <class T>
+    void object3d<T>::start_substeps(bool reverse) {
+        if (sequences[cursor].interpolation() == EULER)
+            return;
+
+        start_orientation = quaternion<T>::rotation_degrees(partial_relative_rotation);
+        stop_orientation = quaternion<T>::rotation_degrees(partial_relative_rotation + sequences[cursor].next_step().rotation());
+
+        if (sequences[cursor].interpolation() != INCREMENTAL)
+            return;
+
+        // slerp(start, stop, t) == (stop * start^-1)^t * start, so every forward substep is the same left factor
+        // and every backward one its conjugate
+        const T fraction = static_cast<T>(1) / sequences[cursor].substeps();
+        delta_orientation = quaternion<T>::slerp(quaternion<T>::identity(), stop_orientation * start_orientation.conjugate(), fraction);
+
+        incremental_orientation = reverse ? stop_orientation : start_orientation;
+        incremental_substeps = 0;
+        incremental_reverse = reverse;
+    }
+
+    template <class T>
+    void object3d<T>::substep(const step3d<T>& substep, bool reverse) {
+        switch (sequences[cursor].interpolation()) {
+            case EULER:
+                this->step(substep);
+                return;
+
+            case INCREMENTAL:
+                // the delta is only the same every substep under uniform easing
+                if (sequences[cursor].easing() == UNIFORM)
+                    break;
+                [[fallthrough]];
+
+            case SLERP:
+                this->relative_translation += substep.translation();
+                this->orient(quaternion<T>::slerp(start_orientation, stop_orientation, sequences[cursor].progress()));
+                return;
+        }
+
+        // a reversal partway re-anchors too, so the drift composed one way is not carried back
+        if (reverse != incremental_reverse || ++incremental_substeps % reanchor_substeps == 0) {
+            incremental_orientation = quaternion<T>::slerp(start_orientation, stop_orientation, sequences[cursor].progress());
+            incremental_substeps = 0;
+            incremental_reverse = reverse;
+        } else {
+            incremental_orientation = (reverse ? delta_orientation.conjugate() : delta_orientation) * incremental_orientation;
+            incremental_orientation *= (3 - incremental_orientation.dot(incremental_orientation)) / 2; // first order renormalization
+        }
+
+        // the euler view follows the linear substeps, it is exact again once the sequence stops
+        this->relative_translation += substep.translation();
+        this->relative_rotation += substep.rotation();
+        this->relative_orientation = incremental_orientation;
+        this->update();
+    }
+
+    // the oldest checkpoint is rolled onto the next sequence unless the next one already has its own
+    template <class T>
+    void object3d<T>::drop_oldest() {
+        if (checkpoints.size() > 1 && checkpoints[1].first == dropped + 1) {
+            checkpoints.pop_front();
+        } else if (!checkpoints.empty()) {
+            checkpoints.front().first++;
+            checkpoints.front().second += sequences[0].next_step();
+        }
+
+        sequences.pop_front();
+        dropped++;
+    }
+
+    // kept sorted, a rewind or a forward skip can reach a multiple out of order or miss it entirely
+    template <class T>
+    void object3d<T>::checkpoint(size_t index, const step3d<T>& start) {
+        auto position = std::lower_bound(checkpoints.begin(), checkpoints.end(), index,
+                                         [](const auto& checkpoint, size_t index) { return checkpoint.first < index; });
+
+        if (position == checkpoints.end() || position->first != index)
+            checkpoints.emplace(position, index, start);
+    }
+
     template <class T>
     class basic_gnu_object3d;
 
@@ -477,7 +1409,8 @@ namespace object {
         basic_gnu_object3d() = delete;
 
         explicit basic_gnu_object3d(const std::vector<vector3d<T>>& absolute_vertexes,
-                                    const std::vector<std::vector<size_t>>& vertex_order) noexcept;
+                                    const std::vector<std::vector<size_t>>& vertex_order);
+        explicit basic_gnu_object3d(const shared_mesh3d<T>& mesh);
 
         static basic_gnu_object3d<O<T>> read(const std::vector<std::vector<vector3d<T>>>& polygons);
         static basic_gnu_object3d<O<T>> read(std::istream& in);
@@ -485,15 +1418,16 @@ namespace object {
 
         void write(std::ostream& out);
         void write(const std::string& path);
-
-    protected:
-        std::vector<std::vector<size_t>> vertex_order;
     };
 
     template <class T, template <class> class O>
     basic_gnu_object3d<O<T>>::basic_gnu_object3d(const std::vector<geometry::vector3d<T>>& absolute_vertexes,
-                                                 const std::vector<std::vector<size_t>>& vertex_order) noexcept
-        : O<T>(absolute_vertexes), vertex_order(vertex_order) {}
+                                                 const std::vector<std::vector<size_t>>& vertex_order)
+        : O<T>(std::make_shared<const mesh3d<T>>(absolute_vertexes, vertex_order)) {}
+
+    template <class T, template <class> class O>
+    basic_gnu_object3d<O<T>>::basic_gnu_object3d(const shared_mesh3d<T>& mesh)
+        : O<T>(mesh) {}
 
     template <class T, template <class> class O>
     basic_gnu_object3d<O<T>> basic_gnu_object3d<O<T>>::read(const std::vector<std::vector<vector3d<T>>>& polygons) {
@@ -570,9 +1504,12 @@ namespace object {
 
     template <class T, template <class> class O>
     void basic_gnu_object3d<O<T>>::write(std::ostream& out) {
+        const vertex_buffer3d<T>& vertexes = this->vertexes();
+        const std::vector<std::vector<size_t>>& vertex_order = this->_mesh->vertex_order();
+
         for (size_t i = 0, x = vertex_order.size(); i < x; i++) {
             for (size_t j = 0, y = vertex_order[i].size(); j < y; j++) {
-                out << this->relative_vertexes[vertex_order[i][j]];
+                out << vertexes[vertex_order[i][j]];
                 if (j < y - 1)
                     out << "\n";
             }
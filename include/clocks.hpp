@@ -0,0 +1,164 @@
+#ifndef DRONE_CLOCKS_HPP
+#define DRONE_CLOCKS_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+#include "../inc/object.hpp"
+
+namespace drone::clocks {
+
+    // fixed timestep accumulator, based on: Fiedler, "Fix your timestep!" (2004),
+    // real time is fed in as it passes and consumed in whole physics steps, the remainder
+    // is left over as the fraction between the last two steps that rendering blends by
+    template <class T>
+    class fixed_clock {
+    public:
+        fixed_clock() = delete;
+        explicit fixed_clock(T step, size_t max_steps = 64) noexcept;
+
+        size_t advance(T elapsed);
+
+        template <class F>
+        size_t advance(T elapsed, F callback);
+
+        T step() const;
+        T alpha() const;
+        T time() const;
+        size_t ticks() const;
+
+    private:
+        T _step;
+        T accumulator = 0;
+
+        // a frame owing more steps than this drops the rest, so a slow frame cannot snowball into slower ones
+        size_t max_steps;
+        size_t _ticks = 0;
+    };
+
+    template <class T>
+    fixed_clock<T>::fixed_clock(T step, size_t max_steps) noexcept
+        : _step(step), max_steps(max_steps) {}
+
+    // steps due after elapsed more seconds, the caller runs them
+    template <class T>
+    size_t fixed_clock<T>::advance(T elapsed) {
+        accumulator += elapsed;
+
+        size_t steps = static_cast<size_t>(accumulator / _step);
+
+        if (steps > max_steps) {
+            steps = max_steps;
+            accumulator = 0;
+        } else {
+            accumulator -= steps * _step;
+        }
+
+        _ticks += steps;
+        return steps;
+    }
+
+    // runs callback once per due step
+    template <class T>
+    template <class F>
+    size_t fixed_clock<T>::advance(T elapsed, F callback) {
+        const size_t steps = advance(elapsed);
+
+        for (size_t i = 0; i < steps; i++)
+            callback();
+        return steps;
+    }
+
+    template <class T>
+    T fixed_clock<T>::step() const {
+        return _step;
+    }
+
+    // how far rendering is past the last step, in [0, 1)
+    template <class T>
+    T fixed_clock<T>::alpha() const {
+        return std::clamp(accumulator / _step, T(0), T(1));
+    }
+
+    // simulated seconds, counted in whole steps so it does not drift
+    template <class T>
+    T fixed_clock<T>::time() const {
+        return _ticks * _step;
+    }
+
+    template <class T>
+    size_t fixed_clock<T>::ticks() const {
+        return _ticks;
+    }
+
+    // the last two poses a dynamic_object3d took at fixed steps, blended for rendering in between,
+    // only poses are kept, so the simulated object never transforms vertexes for frames nobody draws
+    template <class T>
+    class pose_history3d {
+    public:
+        using vector_type = object::vector3d<T>;
+        using quaternion_type = object::quaternion<T>;
+        using pose_type = object::affine3d<T>;
+
+        pose_history3d() = delete;
+        explicit pose_history3d(const object::dynamic_object3d<T>& object);
+
+        void record(const object::dynamic_object3d<T>& object);
+
+        vector_type translation(T alpha) const;
+        quaternion_type orientation(T alpha) const;
+        pose_type pose(T alpha) const;
+
+        void apply(T alpha, object::dynamic_object3d<T>& target) const;
+
+    private:
+        object::shared_mesh3d<T> mesh;
+
+        vector_type previous_translation;
+        vector_type current_translation;
+
+        quaternion_type previous_orientation;
+        quaternion_type current_orientation;
+    };
+
+    template <class T>
+    pose_history3d<T>::pose_history3d(const object::dynamic_object3d<T>& object)
+        : mesh(object.mesh()),
+          previous_translation(object.translation()),
+          current_translation(object.translation()),
+          previous_orientation(object.orientation()),
+          current_orientation(object.orientation()) {}
+
+    // called after every step
+    template <class T>
+    void pose_history3d<T>::record(const object::dynamic_object3d<T>& object) {
+        previous_translation = current_translation;
+        previous_orientation = current_orientation;
+
+        current_translation = object.translation();
+        current_orientation = object.orientation();
+    }
+
+    template <class T>
+    typename pose_history3d<T>::vector_type pose_history3d<T>::translation(T alpha) const {
+        return previous_translation + (current_translation - previous_translation) * alpha;
+    }
+
+    template <class T>
+    typename pose_history3d<T>::quaternion_type pose_history3d<T>::orientation(T alpha) const {
+        return quaternion_type::slerp(previous_orientation, current_orientation, alpha);
+    }
+
+    template <class T>
+    typename pose_history3d<T>::pose_type pose_history3d<T>::pose(T alpha) const {
+        return pose_type::translating(translation(alpha)) * pose_type::rotating(orientation(alpha), mesh->origin());
+    }
+
+    // places a render copy sharing the mesh, which transforms its vertexes once, when they are written out
+    template <class T>
+    void pose_history3d<T>::apply(T alpha, object::dynamic_object3d<T>& target) const {
+        target.place(translation(alpha), orientation(alpha));
+    }
+}
+
+#endif //DRONE_CLOCKS_HPP
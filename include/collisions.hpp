@@ -2,12 +2,969 @@
 #define DRONE_COLLISIONS_HPP
 
 #include <iostream>
+#include <vector>
+#include <unordered_set>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <optional>
 
-#include "../include/events.hpp"
+#include "../inc/object.hpp"
 
-namespace drone::events {
+namespace drone::collisions {
 
-}
+    // incremental sweep and prune over three axis sorted endpoint lists, based on: Baraff,
+    // "Dynamic simulation of non-penetrating rigid bodies" (1992), section 6.3,
+    // boxes barely move between frames so insertion sort runs close to linear and each swap
+    // of a lower past an upper endpoint is exactly where a pair may start or stop overlapping
+    template <class T>
+    class sweep_and_prune {
+    public:
+        using box_type = object::aabb3d<T>;
+        using handle_type = std::uint32_t;
+        using pair_type = std::pair<handle_type, handle_type>;
+
+        handle_type insert(const box_type& box);
+        void erase(handle_type handle);
+
+        void update(handle_type handle, const box_type& box);
+        const std::vector<pair_type>& update_pairs();
+
+        const std::vector<pair_type>& pairs() const;
+        const box_type& box(handle_type handle) const;
+
+        size_t size() const;
+
+    private:
+        struct endpoint {
+            T value;
+            std::uint32_t data; // handle << 1 | upper
+        };
+
+        static std::uint64_t pair_key(handle_type first, handle_type second);
+        static bool precedes(const endpoint& first, const endpoint& second);
+
+        void add_pair(handle_type first, handle_type second);
+        void remove_pair(handle_type first, handle_type second);
+
+        void refresh_axis(size_t axis);
+        void sort_axis(size_t axis);
+        void rebuild();
+
+        std::vector<endpoint> endpoints[3];
+
+        std::vector<box_type> boxes;
+        std::vector<bool> alive;
+        std::vector<handle_type> free_handles;
+        size_t pending_inserts = 0;
+
+        std::unordered_set<std::uint64_t> overlapping;
+        std::vector<std::uint32_t> pair_counts; // lets separating swaps skip the set for boxes without pairs
+        std::vector<pair_type> candidate_pairs;
+    };
+
+    template <class T>
+    typename sweep_and_prune<T>::handle_type sweep_and_prune<T>::insert(const box_type& box) {
+        handle_type handle;
+
+        if (free_handles.empty()) {
+            handle = static_cast<handle_type>(boxes.size());
+            boxes.push_back(box);
+            alive.push_back(true);
+            pair_counts.push_back(0);
+        } else {
+            handle = free_handles.back();
+            free_handles.pop_back();
+            boxes[handle] = box;
+            alive[handle] = true;
+        }
+
+        // appended at the far end, the next sort moves them into place and reports their pairs
+        for (size_t axis = 0; axis < 3; axis++) {
+            endpoints[axis].push_back({box.lower(axis), handle << 1u});
+            endpoints[axis].push_back({box.upper(axis), handle << 1u | 1u});
+        }
+
+        pending_inserts++;
+        return handle;
+    }
+
+    template <class T>
+    void sweep_and_prune<T>::erase(handle_type handle) {
+        for (auto& axis_endpoints : endpoints)
+            axis_endpoints.erase(std::remove_if(axis_endpoints.begin(), axis_endpoints.end(),
+                                                [=](const endpoint& e) { return e.data >> 1u == handle; }),
+                                 axis_endpoints.end());
+
+        for (auto it = overlapping.begin(); pair_counts[handle] && it != overlapping.end();) {
+            const handle_type first = static_cast<handle_type>(*it >> 32u), second = static_cast<handle_type>(*it);
+
+            if (first == handle || second == handle) {
+                pair_counts[first]--;
+                pair_counts[second]--;
+                it = overlapping.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        alive[handle] = false;
+        free_handles.push_back(handle);
+    }
+
+    template <class T>
+    void sweep_and_prune<T>::update(handle_type handle, const box_type& box) {
+        boxes[handle] = box;
+    }
+
+    template <class T>
+    const std::vector<typename sweep_and_prune<T>::pair_type>& sweep_and_prune<T>::update_pairs() {
+        // a large batch of new boxes is far from sorted, so coherence does not help there
+        if (pending_inserts * 4 > size()) {
+            rebuild();
+        } else {
+            for (size_t axis = 0; axis < 3; axis++) {
+                refresh_axis(axis);
+                sort_axis(axis);
+            }
+        }
+
+        pending_inserts = 0;
+
+        candidate_pairs.clear();
+        candidate_pairs.reserve(overlapping.size());
+
+        for (std::uint64_t key : overlapping)
+            candidate_pairs.emplace_back(static_cast<handle_type>(key >> 32u), static_cast<handle_type>(key));
+        return candidate_pairs;
+    }
+
+    template <class T>
+    const std::vector<typename sweep_and_prune<T>::pair_type>& sweep_and_prune<T>::pairs() const {
+        return candidate_pairs;
+    }
+
+    template <class T>
+    const typename sweep_and_prune<T>::box_type& sweep_and_prune<T>::box(handle_type handle) const {
+        return boxes[handle];
+    }
+
+    template <class T>
+    size_t sweep_and_prune<T>::size() const {
+        return boxes.size() - free_handles.size();
+    }
+
+    template <class T>
+    std::uint64_t sweep_and_prune<T>::pair_key(handle_type first, handle_type second) {
+        if (first > second)
+            std::swap(first, second);
+        return static_cast<std::uint64_t>(first) << 32u | second;
+    }
+
+    // touching boxes overlap, so lower endpoints go first among equal values
+    template <class T>
+    bool sweep_and_prune<T>::precedes(const endpoint& first, const endpoint& second) {
+        return first.value < second.value || (first.value == second.value && !(first.data & 1u) && second.data & 1u);
+    }
+
+    template <class T>
+    void sweep_and_prune<T>::add_pair(handle_type first, handle_type second) {
+        if (overlapping.insert(pair_key(first, second)).second) {
+            pair_counts[first]++;
+            pair_counts[second]++;
+        }
+    }
+
+    template <class T>
+    void sweep_and_prune<T>::remove_pair(handle_type first, handle_type second) {
+        if (!pair_counts[first] || !pair_counts[second])
+            return;
+
+        if (overlapping.erase(pair_key(first, second))) {
+            pair_counts[first]--;
+            pair_counts[second]--;
+        }
+    }
+
+    template <class T>
+    void sweep_and_prune<T>::refresh_axis(size_t axis) {
+        for (endpoint& e : endpoints[axis]) {
+            const box_type& box = boxes[e.data >> 1u];
+            e.value = e.data & 1u ? box.upper(axis) : box.lower(axis);
+        }
+    }
+
+    template <class T>
+    void sweep_and_prune<T>::sort_axis(size_t axis) {
+        std::vector<endpoint>& list = endpoints[axis];
+
+        for (size_t i = 1; i < list.size(); i++) {
+            const endpoint moving = list[i];
+            const handle_type handle = moving.data >> 1u;
+            size_t j = i;
+
+            for (; j > 0 && precedes(moving, list[j - 1]); j--) {
+                const endpoint& passed = list[j - 1];
+                const handle_type other = passed.data >> 1u;
+
+                if (!(moving.data & 1u) && passed.data & 1u) {
+                    if (boxes[handle].check_bounds(boxes[other]))
+                        add_pair(handle, other);
+                } else if (moving.data & 1u && !(passed.data & 1u)) {
+                    remove_pair(handle, other);
+                }
+
+                list[j] = passed;
+            }
+
+            list[j] = moving;
+        }
+    }
+
+    // full sort of every axis, then the pairs from one sweep along the first
+    template <class T>
+    void sweep_and_prune<T>::rebuild() {
+        for (size_t axis = 0; axis < 3; axis++) {
+            refresh_axis(axis);
+            std::sort(endpoints[axis].begin(), endpoints[axis].end(), precedes);
+        }
+
+        overlapping.clear();
+        std::fill(pair_counts.begin(), pair_counts.end(), 0);
+
+        std::vector<handle_type> active;
+
+        for (const endpoint& e : endpoints[0]) {
+            const handle_type handle = e.data >> 1u;
+
+            if (e.data & 1u) {
+                *std::find(active.begin(), active.end(), handle) = active.back();
+                active.pop_back();
+            } else {
+                for (handle_type other : active)
+                    if (boxes[handle].check_bounds(boxes[other]))
+                        add_pair(handle, other);
+                active.push_back(handle);
+            }
+        }
+    }
+
+    // per pair indexes of the vertexes spanning the last gjk simplex, objects barely move
+    // between frames so restarting from them usually converges in one or two iterations
+    struct simplex_cache {
+        std::uint32_t first[4];
+        std::uint32_t second[4];
+        std::uint8_t size = 0;
+    };
+
+    template <class T>
+    struct contact3d {
+        bool intersecting = false;
+        T distance = 0; // separation while apart
+        T depth = 0; // penetration while intersecting
+        object::vector3d<T> normal; // unit, from first towards second
+    };
+
+    // narrowphase over the convex hulls of two vertex sets, such as static_object3d::vertexes(),
+    // gjk distance based on: van den Bergen, "A fast and robust GJK implementation for collision detection
+    // of convex objects" (1999), penetration by the expanding polytope algorithm on the final gjk simplex
+    template <class T>
+    class narrowphase {
+    public:
+        using vector_type = object::vector3d<T>;
+        using buffer_type = object::vertex_buffer3d<T>;
+        using contact_type = contact3d<T>;
+
+        static constexpr size_t max_iterations = 64;
+        static constexpr size_t max_expansions = 128;
+
+        static bool intersecting(const buffer_type& first, const buffer_type& second, simplex_cache* cache = nullptr);
+
+        // exact up to max_distance, beyond it the search stops at the first lower bound that exceeds it
+        static T distance(const buffer_type& first, const buffer_type& second,
+                          T max_distance = std::numeric_limits<T>::max(), simplex_cache* cache = nullptr);
+
+        static contact_type collide(const buffer_type& first, const buffer_type& second, simplex_cache* cache = nullptr);
+
+    private:
+        struct support_point {
+            vector_type point;
+            std::uint32_t first;
+            std::uint32_t second;
+        };
+
+        struct simplex {
+            support_point points[4];
+            size_t size = 0;
+        };
+
+        struct face {
+            std::uint32_t vertexes[3];
+            vector_type normal;
+            T distance;
+        };
+
+        static std::uint32_t support(const buffer_type& buffer, const vector_type& direction);
+        static support_point support(const buffer_type& first, const buffer_type& second, const vector_type& direction);
+        static support_point support(const buffer_type& first, const buffer_type& second,
+                                     std::uint32_t first_index, std::uint32_t second_index);
+
+        static vector_type closest(simplex& points);
+        static vector_type closest_segment(simplex& points);
+        static vector_type closest_triangle(simplex& points);
+        static vector_type closest_tetrahedron(simplex& points);
+
+        static T gjk(const buffer_type& first, const buffer_type& second, T max_distance,
+                     simplex_cache* cache, simplex& points, vector_type& nearest);
+
+        static bool enclose(const buffer_type& first, const buffer_type& second, simplex& points);
+        static contact_type epa(const buffer_type& first, const buffer_type& second, simplex& points);
+
+        static face make_face(const std::vector<support_point>& polytope, std::uint32_t a, std::uint32_t b, std::uint32_t c);
+
+        static constexpr T tolerance();
+    };
+
+    template <class T>
+    bool narrowphase<T>::intersecting(const buffer_type& first, const buffer_type& second, simplex_cache* cache) {
+        simplex points;
+        vector_type nearest;
+
+        return gjk(first, second, 0, cache, points, nearest) <= 0;
+    }
+
+    template <class T>
+    T narrowphase<T>::distance(const buffer_type& first, const buffer_type& second, T max_distance, simplex_cache* cache) {
+        simplex points;
+        vector_type nearest;
+
+        return gjk(first, second, max_distance, cache, points, nearest);
+    }
+
+    template <class T>
+    typename narrowphase<T>::contact_type
+    narrowphase<T>::collide(const buffer_type& first, const buffer_type& second, simplex_cache* cache) {
+        simplex points;
+        vector_type nearest;
+
+        const T separation = gjk(first, second, std::numeric_limits<T>::max(), cache, points, nearest);
+
+        if (separation > 0) {
+            contact_type contact;
+            contact.distance = separation;
+            contact.normal = nearest / -separation;
+            return contact;
+        }
+        return epa(first, second, points);
+    }
+
+    template <class T>
+    std::uint32_t narrowphase<T>::support(const buffer_type& buffer, const vector_type& direction) {
+        const T* x = buffer.data(0);
+        const T* y = buffer.data(1);
+        const T* z = buffer.data(2);
+
+        std::uint32_t best = 0;
+        T best_projection = std::numeric_limits<T>::lowest();
+
+        for (size_t i = 0; i < buffer.size(); i++) {
+            const T projection = x[i] * direction[0] + y[i] * direction[1] + z[i] * direction[2];
+
+            if (projection > best_projection) {
+                best_projection = projection;
+                best = static_cast<std::uint32_t>(i);
+            }
+        }
+        return best;
+    }
+
+    // support of the minkowski difference first - second
+    template <class T>
+    typename narrowphase<T>::support_point
+    narrowphase<T>::support(const buffer_type& first, const buffer_type& second, const vector_type& direction) {
+        return support(first, second, support(first, direction), support(second, vector_type(direction * T(-1))));
+    }
+
+    template <class T>
+    typename narrowphase<T>::support_point narrowphase<T>::support(const buffer_type& first, const buffer_type& second,
+                                                                  std::uint32_t first_index, std::uint32_t second_index) {
+        return {vector_type(first[first_index] - second[second_index]), first_index, second_index};
+    }
+
+    // point of the simplex nearest to the origin, the simplex is reduced to the vertexes spanning it
+    template <class T>
+    typename narrowphase<T>::vector_type narrowphase<T>::closest(simplex& points) {
+        switch (points.size) {
+            case 1:
+                return points.points[0].point;
+            case 2:
+                return closest_segment(points);
+            case 3:
+                return closest_triangle(points);
+            default:
+                return closest_tetrahedron(points);
+        }
+    }
+
+    template <class T>
+    typename narrowphase<T>::vector_type narrowphase<T>::closest_segment(simplex& points) {
+        const vector_type& a = points.points[0].point;
+        const vector_type ab = points.points[1].point - a;
+
+        const T length = ab * ab;
+        const T t = length > 0 ? -(a * ab) / length : 0;
+
+        if (t <= 0) {
+            points.size = 1;
+            return a;
+        }
+        if (t >= 1) {
+            points.points[0] = points.points[1];
+            points.size = 1;
+            return points.points[0].point;
+        }
+        return vector_type(a + ab * t);
+    }
+
+    // voronoi regions of the triangle, based on: Ericson, "Real-Time Collision Detection" (2004), section 5.1.5
+    template <class T>
+    typename narrowphase<T>::vector_type narrowphase<T>::closest_triangle(simplex& points) {
+        const support_point a = points.points[0], b = points.points[1], c = points.points[2];
+
+        const vector_type ab = b.point - a.point;
+        const vector_type ac = c.point - a.point;
+
+        const T d1 = -(ab * a.point), d2 = -(ac * a.point);
+        if (d1 <= 0 && d2 <= 0) {
+            points.size = 1;
+            return a.point;
+        }
+
+        const T d3 = -(ab * b.point), d4 = -(ac * b.point);
+        if (d3 >= 0 && d4 <= d3) {
+            points.points[0] = b;
+            points.size = 1;
+            return b.point;
+        }
+
+        const T vc = d1 * d4 - d3 * d2;
+        if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+            points.size = 2;
+            return vector_type(a.point + ab * (d1 / (d1 - d3)));
+        }
+
+        const T d5 = -(ab * c.point), d6 = -(ac * c.point);
+        if (d6 >= 0 && d5 <= d6) {
+            points.points[0] = c;
+            points.size = 1;
+            return c.point;
+        }
+
+        const T vb = d5 * d2 - d1 * d6;
+        if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+            points.points[1] = c;
+            points.size = 2;
+            return vector_type(a.point + ac * (d2 / (d2 - d6)));
+        }
+
+        const T va = d3 * d6 - d5 * d4;
+        if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0) {
+            points.points[0] = b;
+            points.points[1] = c;
+            points.size = 2;
+
+            const vector_type bc = c.point - b.point;
+            return vector_type(b.point + bc * ((d4 - d3) / ((d4 - d3) + (d5 - d6))));
+        }
+
+        const T denominator = 1 / (va + vb + vc);
+        return vector_type(a.point + ab * (vb * denominator) + ac * (vc * denominator));
+    }
+
+    // the nearest of the faces the origin lies outside of, or the origin itself when it is enclosed
+    template <class T>
+    typename narrowphase<T>::vector_type narrowphase<T>::closest_tetrahedron(simplex& points) {
+        static constexpr size_t faces[4][4] = {{0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {1, 3, 2, 0}};
+
+        simplex best;
+        vector_type nearest = vector_type::zeros();
+        T best_distance = std::numeric_limits<T>::max();
+
+        // flat tetrahedra enclose nothing and their side tests are noise, so every face is tried
+        const vector_type& origin = points.points[0].point;
+        const vector_type base = cross(vector_type(points.points[1].point - origin), vector_type(points.points[2].point - origin));
+        const vector_type apex = points.points[3].point - origin;
+        const T volume = base * apex;
+        const bool flat = volume * volume <= tolerance() * tolerance() * (base * base) * (apex * apex);
+
+        for (const size_t (&indexes)[4] : faces) {
+            const vector_type& a = points.points[indexes[0]].point;
+            const vector_type normal = cross(vector_type(points.points[indexes[1]].point - a),
+                                             vector_type(points.points[indexes[2]].point - a));
+
+            const T origin_side = -(normal * a);
+            const T opposite_side = normal * (points.points[indexes[3]].point - a);
+
+            if (!flat && origin_side * opposite_side > 0)
+                continue;
+
+            simplex candidate;
+            candidate.size = 3;
+            for (size_t i = 0; i < 3; i++)
+                candidate.points[i] = points.points[indexes[i]];
+
+            const vector_type point = closest_triangle(candidate);
+            const T distance = point * point;
+
+            if (distance < best_distance) {
+                best_distance = distance;
+                best = candidate;
+                nearest = point;
+            }
+        }
+
+        if (best_distance < std::numeric_limits<T>::max())
+            points = best;
+        return nearest;
+    }
 
+    // distance between the hulls, 0 when they intersect, the final simplex and
+    // its point nearest to the origin are left in points and nearest
+    template <class T>
+    T narrowphase<T>::gjk(const buffer_type& first, const buffer_type& second, T max_distance,
+                          simplex_cache* cache, simplex& points, vector_type& nearest) {
+        points.size = 0;
+
+        if (cache)
+            for (size_t i = 0; i < cache->size; i++)
+                if (cache->first[i] < first.size() && cache->second[i] < second.size())
+                    points.points[points.size++] = support(first, second, cache->first[i], cache->second[i]);
+
+        if (points.size == 0)
+            points.points[points.size++] = support(first, second, vector_type(1, 0, 0));
+
+        T result = 0;
+
+        simplex previous_points;
+        vector_type previous_nearest;
+        T previous_length = std::numeric_limits<T>::max();
+
+        for (size_t iteration = 0; iteration < max_iterations; iteration++) {
+            nearest = closest(points);
+            const T length = nearest * nearest;
+
+            // rounding can stall the descent on nearly degenerate simplices, the last strict progress stands
+            if (length >= previous_length) {
+                points = previous_points;
+                nearest = previous_nearest;
+                break;
+            }
+
+            T scale = 0;
+            for (size_t i = 0; i < points.size; i++)
+                scale = std::max(scale, points.points[i].point * points.points[i].point);
+
+            if (points.size == 4 || length <= std::numeric_limits<T>::epsilon() * scale) {
+                result = 0;
+                break;
+            }
+
+            const support_point next = support(first, second, vector_type(nearest * T(-1)));
+            const T projection = nearest * next.point;
+
+            result = std::sqrt(length);
+
+            // the plane through next normal to nearest separates the hulls by at least projection / |nearest|
+            if (projection > 0 && projection * projection > max_distance * max_distance * length) {
+                result = projection / result;
+                break;
+            }
+
+            if (length - projection <= tolerance() * length)
+                break;
+
+            bool repeated = false;
+            for (size_t i = 0; i < points.size; i++)
+                repeated |= points.points[i].first == next.first && points.points[i].second == next.second;
+            if (repeated)
+                break;
+
+            previous_points = points;
+            previous_nearest = nearest;
+            previous_length = length;
+
+            points.points[points.size++] = next;
+        }
+
+        if (cache) {
+            cache->size = static_cast<std::uint8_t>(points.size);
+            for (size_t i = 0; i < points.size; i++) {
+                cache->first[i] = points.points[i].first;
+                cache->second[i] = points.points[i].second;
+            }
+        }
+        return result;
+    }
+
+    // grows a simplex touching the origin into a tetrahedron, false when the minkowski difference is flat
+    template <class T>
+    bool narrowphase<T>::enclose(const buffer_type& first, const buffer_type& second, simplex& points) {
+        static const vector_type axes[3] = {vector_type(1, 0, 0), vector_type(0, 1, 0), vector_type(0, 0, 1)};
+
+        auto grow = [&](const vector_type& direction, const vector_type& base, T threshold) {
+            for (const T sign : {T(1), T(-1)}) {
+                const support_point next = support(first, second, vector_type(direction * sign));
+
+                if (std::abs(direction * (next.point - base)) > threshold) {
+                    points.points[points.size++] = next;
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        T scale = 0;
+        for (size_t i = 0; i < points.size; i++)
+            scale = std::max(scale, std::sqrt(points.points[i].point * points.points[i].point));
+        const T threshold = tolerance() * std::max(scale, T(1));
+
+        if (points.size == 1) {
+            bool grown = false;
+            for (size_t i = 0; i < 3 && !grown; i++)
+                grown = grow(axes[i], points.points[0].point, threshold);
+            if (!grown)
+                return false;
+        }
+
+        if (points.size == 2) {
+            const vector_type direction = points.points[1].point - points.points[0].point;
+            const vector_type unit = direction / std::sqrt(direction * direction);
+
+            bool grown = false;
+            for (size_t i = 0; i < 3 && !grown; i++) {
+                const vector_type normal = cross(unit, axes[i]);
+                grown = normal * normal > T(0.25) && grow(normal, points.points[0].point, threshold);
+            }
+            if (!grown)
+                return false;
+        }
+
+        if (points.size == 3) {
+            const vector_type& a = points.points[0].point;
+            vector_type normal = cross(vector_type(points.points[1].point - a), vector_type(points.points[2].point - a));
+            normal /= std::sqrt(normal * normal);
+
+            if (!grow(normal, a, threshold))
+                return false;
+        }
+        return true;
+    }
+
+    // expands the polytope towards the face nearest to the origin until no support point reaches past it,
+    // based on: van den Bergen, "Proximity queries and penetration depth computation on 3D game objects" (2001)
+    template <class T>
+    typename narrowphase<T>::contact_type narrowphase<T>::epa(const buffer_type& first, const buffer_type& second, simplex& points) {
+        contact_type contact;
+        contact.intersecting = true;
+        contact.normal = vector_type(0, 0, 1);
+
+        if (points.size < 4 && !enclose(first, second, points))
+            return contact;
+
+        std::vector<support_point> polytope(points.points, points.points + 4);
+        std::vector<face> faces;
+
+        static constexpr std::uint32_t tetrahedron[4][4] = {{0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {1, 3, 2, 0}};
+
+        for (const std::uint32_t (&indexes)[4] : tetrahedron) {
+            const vector_type& a = polytope[indexes[0]].point;
+            const vector_type normal = cross(vector_type(polytope[indexes[1]].point - a), vector_type(polytope[indexes[2]].point - a));
+
+            // wound so that the normals face away from the opposite vertex
+            if (normal * (polytope[indexes[3]].point - a) > 0)
+                faces.push_back(make_face(polytope, indexes[0], indexes[2], indexes[1]));
+            else
+                faces.push_back(make_face(polytope, indexes[0], indexes[1], indexes[2]));
+        }
+
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> horizon;
+
+        for (size_t expansion = 0; expansion < max_expansions; expansion++) {
+            const face nearest = *std::min_element(faces.begin(), faces.end(), [](const face& lhs, const face& rhs) {
+                return lhs.distance < rhs.distance;
+            });
+
+            contact.depth = std::max(nearest.distance, T(0));
+            contact.normal = nearest.normal;
+
+            const support_point next = support(first, second, nearest.normal);
+            const T reach = nearest.normal * next.point;
+
+            const bool known = std::any_of(polytope.begin(), polytope.end(), [&](const support_point& point) {
+                return point.first == next.first && point.second == next.second;
+            });
+
+            if (known || reach - nearest.distance <= tolerance() * std::max(nearest.distance, T(1)))
+                break;
+
+            const std::uint32_t index = static_cast<std::uint32_t>(polytope.size());
+            polytope.push_back(next);
+            horizon.clear();
+
+            // faces seen from the new point go, edges shared by two of them cancel out
+            for (size_t i = faces.size(); i-- > 0;) {
+                const face& current = faces[i];
+
+                // points barely past a face count as on it, or coplanar neighbours split the horizon
+                if (current.normal * next.point - current.distance <= tolerance() * std::max(reach, T(1)))
+                    continue;
+
+                for (size_t j = 0; j < 3; j++) {
+                    const std::pair<std::uint32_t, std::uint32_t> edge(current.vertexes[j], current.vertexes[(j + 1) % 3]);
+                    const auto reverse = std::find(horizon.begin(), horizon.end(), std::make_pair(edge.second, edge.first));
+
+                    if (reverse == horizon.end()) {
+                        horizon.push_back(edge);
+                    } else {
+                        *reverse = horizon.back();
+                        horizon.pop_back();
+                    }
+                }
+
+                faces[i] = faces.back();
+                faces.pop_back();
+            }
+
+            for (const auto& edge : horizon)
+                faces.push_back(make_face(polytope, edge.first, edge.second, index));
+
+            if (faces.empty())
+                break;
+        }
+        return contact;
+    }
+
+    template <class T>
+    typename narrowphase<T>::face
+    narrowphase<T>::make_face(const std::vector<support_point>& polytope, std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+        const vector_type& origin = polytope[a].point;
+        vector_type normal = cross(vector_type(polytope[b].point - origin), vector_type(polytope[c].point - origin));
+
+        const T length = std::sqrt(normal * normal);
+        if (length > 0)
+            normal /= length;
+
+        return {{a, b, c}, normal, normal * origin};
+    }
+
+    template <class T>
+    constexpr T narrowphase<T>::tolerance() {
+        return std::numeric_limits<T>::epsilon() < T(1e-10) ? T(1e-8) : T(1e-4);
+    }
+
+    // rigid motion of a dynamic_object3d over one substep, translating linearly and turning about
+    // the mesh origin along the slerp of its orientations, euler substeps are short enough to follow it closely
+    template <class T>
+    class motion3d {
+    public:
+        using vector_type = object::vector3d<T>;
+        using quaternion_type = object::quaternion<T>;
+        using pose_type = object::affine3d<T>;
+
+        motion3d() = delete;
+        explicit motion3d(const object::dynamic_object3d<T>& object); // at rest where the object is
+
+        void stop(const object::dynamic_object3d<T>& object);
+
+        pose_type pose(T fraction) const;
+
+        vector_type translation() const;
+        T angle() const;
+
+        const object::shared_mesh3d<T>& mesh() const;
+
+    private:
+        object::shared_mesh3d<T> _mesh;
+
+        vector_type start_translation;
+        vector_type stop_translation;
+
+        quaternion_type start_orientation;
+        quaternion_type stop_orientation;
+    };
+
+    template <class T>
+    motion3d<T>::motion3d(const object::dynamic_object3d<T>& object)
+        : _mesh(object.mesh()),
+          start_translation(object.translation()),
+          stop_translation(object.translation()),
+          start_orientation(object.orientation()),
+          stop_orientation(object.orientation()) {}
+
+    template <class T>
+    void motion3d<T>::stop(const object::dynamic_object3d<T>& object) {
+        stop_translation = object.translation();
+        stop_orientation = object.orientation();
+    }
+
+    template <class T>
+    typename motion3d<T>::pose_type motion3d<T>::pose(T fraction) const {
+        const vector_type translation = start_translation + (stop_translation - start_translation) * fraction;
+        const quaternion_type orientation = quaternion_type::slerp(start_orientation, stop_orientation, fraction);
+
+        return pose_type::translating(translation) * pose_type::rotating(orientation, _mesh->origin());
+    }
+
+    template <class T>
+    typename motion3d<T>::vector_type motion3d<T>::translation() const {
+        return stop_translation - start_translation;
+    }
+
+    // radians turned over the whole motion
+    template <class T>
+    T motion3d<T>::angle() const {
+        return 2 * std::acos(std::min(std::abs(start_orientation.dot(stop_orientation)), T(1)));
+    }
+
+    template <class T>
+    const object::shared_mesh3d<T>& motion3d<T>::mesh() const {
+        return _mesh;
+    }
+
+    // collision checks over a whole substep instead of at its end, so thin obstacles cannot be stepped over,
+    // times of impact are fractions of the substep, object3d::truncate stops the sequence short at the first one found
+    template <class T>
+    class continuous {
+    public:
+        using box_type = object::aabb3d<T>;
+        using vector_type = object::vector3d<T>;
+        using buffer_type = object::vertex_buffer3d<T>;
+        using motion_type = motion3d<T>;
+
+        static constexpr size_t max_iterations = 32;
+
+        static box_type swept_bounds(const box_type& box, const vector_type& translation);
+        static box_type swept_bounds(const motion_type& motion);
+        static std::optional<T> sweep(const box_type& box, const vector_type& translation, const box_type& obstacle);
+
+        static std::optional<T> time_of_impact(const motion_type& motion, const buffer_type& obstacle, T tolerance);
+        static std::optional<T> time_of_impact(const motion_type& first, const motion_type& second, T tolerance);
+
+    private:
+        static T radius(const object::mesh3d<T>& mesh);
+
+        static std::optional<T> advance(const motion_type& first, const motion_type* second,
+                                        const buffer_type* obstacle, T tolerance);
+    };
+
+    // everything the box covers while translating
+    template <class T>
+    typename continuous<T>::box_type continuous<T>::swept_bounds(const box_type& box, const vector_type& translation) {
+        return box.merged(box_type(vector_type(box.lower() + translation), vector_type(box.upper() + translation)));
+    }
+
+    // everything the mesh covers while translating and turning, the start box swept along the translation
+    // and grown by how far the turn can carry a vertex from its start pose, at most its arc and at most the diameter
+    template <class T>
+    typename continuous<T>::box_type continuous<T>::swept_bounds(const motion_type& motion) {
+        const box_type start = motion.mesh()->bounds().transformed(motion.pose(0));
+        const box_type swept = swept_bounds(start, motion.translation());
+        const T reach = std::min(motion.angle(), T(2)) * radius(*motion.mesh());
+
+        return box_type(vector_type(swept.lower() - reach), vector_type(swept.upper() + reach));
+    }
+
+    // fraction of the translation at which the box starts overlapping the obstacle, 0 when it already does
+    template <class T>
+    std::optional<T> continuous<T>::sweep(const box_type& box, const vector_type& translation, const box_type& obstacle) {
+        T entry = 0, exit = 1;
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            const T near = obstacle.lower(axis) - box.upper(axis);
+            const T far = obstacle.upper(axis) - box.lower(axis);
+
+            if (translation[axis] == 0) {
+                if (near > 0 || far < 0)
+                    return std::nullopt;
+                continue;
+            }
+
+            T first = near / translation[axis];
+            T second = far / translation[axis];
+
+            if (first > second)
+                std::swap(first, second);
+
+            entry = std::max(entry, first);
+            exit = std::min(exit, second);
+        }
+
+        if (entry > exit)
+            return std::nullopt;
+        return entry;
+    }
+
+    template <class T>
+    std::optional<T> continuous<T>::time_of_impact(const motion_type& motion, const buffer_type& obstacle, T tolerance) {
+        return advance(motion, nullptr, &obstacle, tolerance);
+    }
+
+    template <class T>
+    std::optional<T> continuous<T>::time_of_impact(const motion_type& first, const motion_type& second, T tolerance) {
+        return advance(first, &second, nullptr, tolerance);
+    }
+
+    template <class T>
+    T continuous<T>::radius(const object::mesh3d<T>& mesh) {
+        T radius = 0;
+
+        for (const vector_type vertex : mesh.vertexes()) {
+            const vector_type arm = vertex - mesh.origin();
+            radius = std::max(radius, arm * arm);
+        }
+        return std::sqrt(radius);
+    }
+
+    // conservative advancement, based on: Mirtich, "Impulse-based dynamic simulation of rigid body systems" (1996),
+    // no point of either hull approaches the other faster than the translations along the contact normal plus
+    // the turn rates times the farthest vertexes, so advancing by distance over that bound never passes a contact
+    template <class T>
+    std::optional<T> continuous<T>::advance(const motion_type& first, const motion_type* second,
+                                            const buffer_type* obstacle, T tolerance) {
+        const T first_spin = first.angle() * radius(*first.mesh());
+        const T second_spin = second ? second->angle() * radius(*second->mesh()) : 0;
+
+        const vector_type translation = second ? vector_type(first.translation() - second->translation()) : first.translation();
+
+        buffer_type first_vertexes, second_vertexes;
+        simplex_cache cache;
+
+        T fraction = 0;
+
+        for (size_t iteration = 0; iteration < max_iterations; iteration++) {
+            first.pose(fraction).apply(first.mesh()->vertexes(), first_vertexes);
+            if (second)
+                second->pose(fraction).apply(second->mesh()->vertexes(), second_vertexes);
+
+            const contact3d<T> contact = narrowphase<T>::collide(first_vertexes, second ? second_vertexes : *obstacle, &cache);
+
+            if (contact.intersecting || contact.distance <= tolerance)
+                return fraction;
+
+            const T approach = std::max(translation * contact.normal, T(0)) + first_spin + second_spin;
+
+            if (approach <= 0)
+                return std::nullopt;
+
+            fraction += contact.distance / approach;
+
+            if (fraction > 1)
+                return std::nullopt;
+        }
+        return fraction;
+    }
+}
 
 #endif //DRONE_COLLISIONS_HPP
@@ -0,0 +1,208 @@
+#ifndef DRONE_DYNAMICS_HPP
+#define DRONE_DYNAMICS_HPP
+
+#include <vector>
+#include <cstdint>
+
+#include "../inc/object.hpp"
+
+namespace drone::dynamics {
+
+    // free rigid bodies as one array per scalar, integrated by semi-implicit euler, based on:
+    // Hairer, Lubich, Wanner, "Geometric numerical integration" (2006), velocities are advanced first
+    // and positions then move with the new velocities, which keeps orbits and oscillations from gaining energy,
+    // orientations follow q' = (0, w) * q / 2 with the angular velocity w in world axes, in radians per second
+    template <class T>
+    class rigid_bodies {
+    public:
+        using body_type = std::uint32_t;
+        using vector_type = object::vector3d<T>;
+        using quaternion_type = object::quaternion<T>;
+
+        body_type insert(const vector_type& translation, const quaternion_type& orientation);
+        body_type insert(const object::dynamic_object3d<T>& object);
+
+        void set_velocity(body_type body, const vector_type& linear, const vector_type& angular);
+        void set_acceleration(body_type body, const vector_type& linear, const vector_type& angular);
+        void set_gravity(const vector_type& gravity);
+
+        vector_type translation(body_type body) const;
+        quaternion_type orientation(body_type body) const;
+        vector_type velocity(body_type body) const;
+        vector_type angular_velocity(body_type body) const;
+
+        void integrate(T seconds);
+
+        void apply(body_type body, object::dynamic_object3d<T>& object) const;
+
+        size_t size() const;
+        void reserve(size_t size);
+
+    private:
+        static vector_type gather(const std::vector<T> (&components)[3], body_type body);
+        static void scatter(std::vector<T> (&components)[3], body_type body, const vector_type& vector);
+
+        std::vector<T> translations[3];
+        std::vector<T> velocities[3];
+        std::vector<T> accelerations[3];
+
+        std::vector<T> orientations[4]; // w, x, y, z
+        std::vector<T> angular_velocities[3];
+        std::vector<T> angular_accelerations[3];
+
+        T gravity[3] = {0, 0, 0};
+    };
+
+    template <class T>
+    typename rigid_bodies<T>::body_type rigid_bodies<T>::insert(const vector_type& translation, const quaternion_type& orientation) {
+        const auto body = static_cast<body_type>(size());
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            translations[axis].push_back(translation[axis]);
+            velocities[axis].push_back(0);
+            accelerations[axis].push_back(0);
+            angular_velocities[axis].push_back(0);
+            angular_accelerations[axis].push_back(0);
+        }
+
+        const quaternion_type unit = orientation.normalized();
+        for (size_t i = 0; i < 4; i++)
+            orientations[i].push_back(unit[i]);
+
+        return body;
+    }
+
+    template <class T>
+    typename rigid_bodies<T>::body_type rigid_bodies<T>::insert(const object::dynamic_object3d<T>& object) {
+        return insert(object.translation(), object.orientation());
+    }
+
+    template <class T>
+    void rigid_bodies<T>::set_velocity(body_type body, const vector_type& linear, const vector_type& angular) {
+        scatter(velocities, body, linear);
+        scatter(angular_velocities, body, angular);
+    }
+
+    // held until set again, on top of gravity
+    template <class T>
+    void rigid_bodies<T>::set_acceleration(body_type body, const vector_type& linear, const vector_type& angular) {
+        scatter(accelerations, body, linear);
+        scatter(angular_accelerations, body, angular);
+    }
+
+    template <class T>
+    void rigid_bodies<T>::set_gravity(const vector_type& gravity) {
+        for (size_t axis = 0; axis < 3; axis++)
+            this->gravity[axis] = gravity[axis];
+    }
+
+    template <class T>
+    typename rigid_bodies<T>::vector_type rigid_bodies<T>::translation(body_type body) const {
+        return gather(translations, body);
+    }
+
+    template <class T>
+    typename rigid_bodies<T>::quaternion_type rigid_bodies<T>::orientation(body_type body) const {
+        return quaternion_type(orientations[0][body], orientations[1][body], orientations[2][body], orientations[3][body]);
+    }
+
+    template <class T>
+    typename rigid_bodies<T>::vector_type rigid_bodies<T>::velocity(body_type body) const {
+        return gather(velocities, body);
+    }
+
+    template <class T>
+    typename rigid_bodies<T>::vector_type rigid_bodies<T>::angular_velocity(body_type body) const {
+        return gather(angular_velocities, body);
+    }
+
+    // one step for every body, each loop runs over plain arrays so the compiler can vectorize it
+    template <class T>
+    void rigid_bodies<T>::integrate(T seconds) {
+        const size_t count = size();
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            T* translation = translations[axis].data();
+            T* velocity = velocities[axis].data();
+            const T* acceleration = accelerations[axis].data();
+            const T g = gravity[axis];
+
+            for (size_t i = 0; i < count; i++) {
+                velocity[i] += (acceleration[i] + g) * seconds;
+                translation[i] += velocity[i] * seconds;
+            }
+
+            T* angular_velocity = angular_velocities[axis].data();
+            const T* angular_acceleration = angular_accelerations[axis].data();
+
+            for (size_t i = 0; i < count; i++)
+                angular_velocity[i] += angular_acceleration[i] * seconds;
+        }
+
+        T* qw = orientations[0].data();
+        T* qx = orientations[1].data();
+        T* qy = orientations[2].data();
+        T* qz = orientations[3].data();
+
+        const T* wx = angular_velocities[0].data();
+        const T* wy = angular_velocities[1].data();
+        const T* wz = angular_velocities[2].data();
+
+        const T half = seconds / 2;
+
+        for (size_t i = 0; i < count; i++) {
+            const T w = qw[i], x = qx[i], y = qy[i], z = qz[i];
+
+            const T nw = w - half * (wx[i] * x + wy[i] * y + wz[i] * z);
+            const T nx = x + half * (wx[i] * w + wy[i] * z - wz[i] * y);
+            const T ny = y + half * (wy[i] * w + wz[i] * x - wx[i] * z);
+            const T nz = z + half * (wz[i] * w + wx[i] * y - wy[i] * x);
+
+            // the step leaves the unit sphere by O(h^2), so first order renormalization is enough and has no sqrt
+            const T scale = (3 - (nw * nw + nx * nx + ny * ny + nz * nz)) / 2;
+
+            qw[i] = nw * scale;
+            qx[i] = nx * scale;
+            qy[i] = ny * scale;
+            qz[i] = nz * scale;
+        }
+    }
+
+    // places the object, its vertexes are only transformed once they are read
+    template <class T>
+    void rigid_bodies<T>::apply(body_type body, object::dynamic_object3d<T>& object) const {
+        object.place(translation(body), orientation(body));
+    }
+
+    template <class T>
+    size_t rigid_bodies<T>::size() const {
+        return translations[0].size();
+    }
+
+    template <class T>
+    void rigid_bodies<T>::reserve(size_t size) {
+        for (size_t axis = 0; axis < 3; axis++) {
+            translations[axis].reserve(size);
+            velocities[axis].reserve(size);
+            accelerations[axis].reserve(size);
+            angular_velocities[axis].reserve(size);
+            angular_accelerations[axis].reserve(size);
+        }
+
+        for (std::vector<T>& components : orientations)
+            components.reserve(size);
+    }
+
+    template <class T>
+    typename rigid_bodies<T>::vector_type rigid_bodies<T>::gather(const std::vector<T> (&components)[3], body_type body) {
+        return vector_type(components[0][body], components[1][body], components[2][body]);
+    }
+
+    template <class T>
+    void rigid_bodies<T>::scatter(std::vector<T> (&components)[3], body_type body, const vector_type& vector) {
+        for (size_t axis = 0; axis < 3; axis++)
+            components[axis][body] = vector[axis];
+    }
+}
+
+#endif //DRONE_DYNAMICS_HPP
@@ -2,9 +2,1170 @@
 #define DRONE_SCENES_HPP
 
 #include <iostream>
+#include <vector>
+#include <optional>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "../inc/object.hpp"
+#include "../include/workers.hpp"
 
 namespace drone::scenes {
 
+    // objects indexed in a spatial hash of uniform cells by their bounds, every object is listed
+    // in each cell its box touches, so a query only visits the cells its own region touches
+    template <class T, class O = object::object3d<T>>
+    class scene {
+    public:
+        using object_type = O;
+        using box_type = object::aabb3d<T>;
+        using vector_type = object::vector3d<T>;
+        using handle_type = std::uint32_t;
+
+        scene() = delete;
+        explicit scene(T cell_size) noexcept;
+
+        handle_type insert(object_type object);
+        void erase(handle_type handle);
+
+        object_type& object(handle_type handle);
+        const object_type& object(handle_type handle) const;
+
+        const box_type& bounds(handle_type handle) const;
+
+        void update(handle_type handle);
+        void update();
+
+        void refresh(handle_type handle);
+        void reindex(handle_type handle);
+        void reindex();
+
+        std::vector<handle_type> query_region(const box_type& region) const;
+        std::vector<handle_type> query_radius(const vector_type& center, T radius) const;
+        std::vector<handle_type> query_neighbors(handle_type handle, T radius) const;
+
+        size_t size() const;
+
+        handle_type capacity() const;
+        bool contains(handle_type handle) const;
+
+    private:
+        struct cell_range {
+            std::int32_t lower[3];
+            std::int32_t upper[3];
+
+            bool operator==(const cell_range& range) const;
+        };
+
+        cell_range cells(const box_type& box) const;
+        std::int32_t cell(T coordinate) const;
+
+        static std::uint64_t cell_count(const cell_range& range);
+        static std::uint64_t cell_key(std::int32_t x, std::int32_t y, std::int32_t z);
+
+        void index(handle_type handle, const cell_range& range);
+        void unindex(handle_type handle, const cell_range& range);
+
+        template <class F>
+        void visit(const box_type& region, F visitor) const;
+
+        T cell_size;
+
+        std::vector<std::optional<object_type>> objects;
+        std::vector<box_type> boxes;
+        std::vector<cell_range> ranges;
+        std::vector<handle_type> free_handles;
+
+        std::unordered_map<std::uint64_t, std::vector<handle_type>> grid;
+
+        // objects spanning more cells than there are objects are kept out of the grid and scanned by every query
+        std::vector<unsigned char> oversized;
+        std::vector<handle_type> oversized_handles;
+    };
+
+    template <class T, class O>
+    bool scene<T, O>::cell_range::operator==(const cell_range& range) const {
+        return std::equal(lower, lower + 3, range.lower) && std::equal(upper, upper + 3, range.upper);
+    }
+
+    template <class T, class O>
+    scene<T, O>::scene(T cell_size) noexcept
+        : cell_size(cell_size) {}
+
+    template <class T, class O>
+    typename scene<T, O>::handle_type scene<T, O>::insert(object_type object) {
+        handle_type handle;
+
+        if (free_handles.empty()) {
+            handle = static_cast<handle_type>(objects.size());
+            objects.emplace_back(std::move(object));
+            boxes.emplace_back();
+            ranges.emplace_back();
+            oversized.push_back(0);
+        } else {
+            handle = free_handles.back();
+            free_handles.pop_back();
+            objects[handle].emplace(std::move(object));
+        }
+
+        boxes[handle] = objects[handle]->bounds();
+        ranges[handle] = cells(boxes[handle]);
+        index(handle, ranges[handle]);
+
+        return handle;
+    }
+
+    template <class T, class O>
+    void scene<T, O>::erase(handle_type handle) {
+        unindex(handle, ranges[handle]);
+        objects[handle].reset();
+        free_handles.push_back(handle);
+    }
+
+    template <class T, class O>
+    typename scene<T, O>::object_type& scene<T, O>::object(handle_type handle) {
+        return *objects[handle];
+    }
+
+    template <class T, class O>
+    const typename scene<T, O>::object_type& scene<T, O>::object(handle_type handle) const {
+        return *objects[handle];
+    }
+
+    template <class T, class O>
+    const typename scene<T, O>::box_type& scene<T, O>::bounds(handle_type handle) const {
+        return boxes[handle];
+    }
+
+    template <class T, class O>
+    void scene<T, O>::update(handle_type handle) {
+        refresh(handle);
+        reindex(handle);
+    }
+
+    template <class T, class O>
+    void scene<T, O>::update() {
+        for (handle_type handle = 0; handle < objects.size(); handle++)
+            if (objects[handle])
+                update(handle);
+    }
+
+    // only writes the box of this handle, so different handles may be refreshed concurrently
+    template <class T, class O>
+    void scene<T, O>::refresh(handle_type handle) {
+        boxes[handle] = objects[handle]->bounds();
+    }
+
+    // objects rarely leave their cells between frames, so most refreshed boxes need no reindexing
+    template <class T, class O>
+    void scene<T, O>::reindex(handle_type handle) {
+        cell_range range = cells(boxes[handle]);
+
+        if (range == ranges[handle])
+            return;
+
+        unindex(handle, ranges[handle]);
+        index(handle, range);
+        ranges[handle] = range;
+    }
+
+    template <class T, class O>
+    void scene<T, O>::reindex() {
+        for (handle_type handle = 0; handle < objects.size(); handle++)
+            if (objects[handle])
+                reindex(handle);
+    }
+
+    template <class T, class O>
+    std::vector<typename scene<T, O>::handle_type> scene<T, O>::query_region(const box_type& region) const {
+        std::vector<handle_type> result;
+
+        visit(region, [&](handle_type handle) {
+            if (boxes[handle].check_bounds(region))
+                result.push_back(handle);
+        });
+        return result;
+    }
+
+    // objects whose bounds come within radius of center
+    template <class T, class O>
+    std::vector<typename scene<T, O>::handle_type> scene<T, O>::query_radius(const vector_type& center, T radius) const {
+        std::vector<handle_type> result;
+        const box_type region(vector_type(center - radius), vector_type(center + radius));
+
+        visit(region, [&](handle_type handle) {
+            T distance = 0;
+
+            for (size_t axis = 0; axis < 3; axis++) {
+                T gap = std::max({boxes[handle].lower(axis) - center[axis], center[axis] - boxes[handle].upper(axis), T(0)});
+                distance += gap * gap;
+            }
+
+            if (distance <= radius * radius)
+                result.push_back(handle);
+        });
+        return result;
+    }
+
+    // objects within radius of the origin of the given one, excluding itself
+    template <class T, class O>
+    std::vector<typename scene<T, O>::handle_type> scene<T, O>::query_neighbors(handle_type handle, T radius) const {
+        std::vector<handle_type> result = query_radius(objects[handle]->origin(), radius);
+
+        result.erase(std::remove(result.begin(), result.end(), handle), result.end());
+        return result;
+    }
+
+    template <class T, class O>
+    size_t scene<T, O>::size() const {
+        return objects.size() - free_handles.size();
+    }
+
+    // handles are below this, live or free
+    template <class T, class O>
+    typename scene<T, O>::handle_type scene<T, O>::capacity() const {
+        return static_cast<handle_type>(objects.size());
+    }
+
+    template <class T, class O>
+    bool scene<T, O>::contains(handle_type handle) const {
+        return handle < objects.size() && objects[handle];
+    }
+
+    template <class T, class O>
+    typename scene<T, O>::cell_range scene<T, O>::cells(const box_type& box) const {
+        cell_range range;
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            range.lower[axis] = cell(box.lower(axis));
+            range.upper[axis] = cell(box.upper(axis));
+        }
+        return range;
+    }
+
+    // clamped to +-2^30 before the cast, which is undefined for huge, infinite or nan coordinates
+    template <class T, class O>
+    std::int32_t scene<T, O>::cell(T coordinate) const {
+        static constexpr T limit = T(1 << 30);
+
+        const T index = std::floor(coordinate / cell_size);
+
+        if (!(index > -limit))
+            return -(1 << 30);
+        if (!(index < limit))
+            return 1 << 30;
+        return static_cast<std::int32_t>(index);
+    }
+
+    // saturates instead of wrapping, ranges can span up to 2^93 cells
+    template <class T, class O>
+    std::uint64_t scene<T, O>::cell_count(const cell_range& range) {
+        static constexpr std::uint64_t limit = std::numeric_limits<std::uint64_t>::max();
+
+        std::uint64_t count = 1;
+        for (size_t axis = 0; axis < 3; axis++) {
+            if (range.upper[axis] < range.lower[axis])
+                return 0;
+
+            const auto extent = static_cast<std::uint64_t>(std::int64_t(range.upper[axis]) - range.lower[axis] + 1);
+            if (count > limit / extent)
+                return limit;
+            count *= extent;
+        }
+        return count;
+    }
+
+    // 21 bits per axis, cells wrap around beyond +-2^20 and only share buckets there
+    template <class T, class O>
+    std::uint64_t scene<T, O>::cell_key(std::int32_t x, std::int32_t y, std::int32_t z) {
+        static constexpr std::uint64_t mask = (1u << 21u) - 1;
+
+        return (static_cast<std::uint64_t>(x) & mask) << 42u |
+               (static_cast<std::uint64_t>(y) & mask) << 21u |
+               (static_cast<std::uint64_t>(z) & mask);
+    }
+
+    template <class T, class O>
+    void scene<T, O>::index(handle_type handle, const cell_range& range) {
+        oversized[handle] = cell_count(range) > objects.size();
+
+        if (oversized[handle]) {
+            oversized_handles.push_back(handle);
+            return;
+        }
+
+        for (std::int32_t x = range.lower[0]; x <= range.upper[0]; x++)
+            for (std::int32_t y = range.lower[1]; y <= range.upper[1]; y++)
+                for (std::int32_t z = range.lower[2]; z <= range.upper[2]; z++)
+                    grid[cell_key(x, y, z)].push_back(handle);
+    }
+
+    template <class T, class O>
+    void scene<T, O>::unindex(handle_type handle, const cell_range& range) {
+        if (oversized[handle]) {
+            *std::find(oversized_handles.begin(), oversized_handles.end(), handle) = oversized_handles.back();
+            oversized_handles.pop_back();
+            return;
+        }
+
+        for (std::int32_t x = range.lower[0]; x <= range.upper[0]; x++) {
+            for (std::int32_t y = range.lower[1]; y <= range.upper[1]; y++) {
+                for (std::int32_t z = range.lower[2]; z <= range.upper[2]; z++) {
+                    auto it = grid.find(cell_key(x, y, z));
+                    std::vector<handle_type>& cell = it->second;
+
+                    *std::find(cell.begin(), cell.end(), handle) = cell.back();
+                    cell.pop_back();
+
+                    if (cell.empty())
+                        grid.erase(it);
+                }
+            }
+        }
+    }
+
+    // every candidate once, in handle order, the visitor still has to test the bounds itself,
+    // a region spanning more cells than there are objects is cheaper to answer by scanning all of them
+    template <class T, class O>
+    template <class F>
+    void scene<T, O>::visit(const box_type& region, F visitor) const {
+        const cell_range range = cells(region);
+
+        if (cell_count(range) > objects.size()) {
+            for (handle_type handle = 0; handle < objects.size(); handle++)
+                if (objects[handle])
+                    visitor(handle);
+            return;
+        }
+
+        // deduplicated per call, so concurrent queries share no state
+        std::vector<handle_type> candidates(oversized_handles);
+
+        for (std::int32_t x = range.lower[0]; x <= range.upper[0]; x++) {
+            for (std::int32_t y = range.lower[1]; y <= range.upper[1]; y++) {
+                for (std::int32_t z = range.lower[2]; z <= range.upper[2]; z++) {
+                    auto it = grid.find(cell_key(x, y, z));
+                    if (it != grid.end())
+                        candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+                }
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        for (handle_type handle : candidates)
+            visitor(handle);
+    }
+
+    // advances every object one substep, transforms its vertexes and refreshes its box on the pool, then reindexes
+    // serially in handle order, objects only touch their own state, so the result does not depend on the threads,
+    // true while any object has substeps left
+    template <class T, class O>
+    bool parallel_step(scene<T, O>& scene, workers::worker_pool& pool, size_t grain = 64) {
+        using handle_type = typename drone::scenes::scene<T, O>::handle_type;
+
+        const handle_type capacity = scene.capacity();
+        std::vector<unsigned char> moving(capacity, 0);
+
+        pool.parallel_for(capacity, grain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const auto handle = static_cast<handle_type>(i);
+                if (!scene.contains(handle))
+                    continue;
+
+                O& object = scene.object(handle);
+                moving[i] = object.next_substep();
+                object.vertexes();
+                scene.refresh(handle);
+            }
+        });
+
+        scene.reindex();
+        return std::find(moving.begin(), moving.end(), 1) != moving.end();
+    }
+
+    // dynamic bounding volume hierarchy over fat boxes, based on: Catto, Box2D b2_dynamic_tree,
+    // inserts descend by surface area cost and every refit on the way up may rotate a child with a grandchild
+    // when that shrinks the surface area, which keeps the tree balanced for the SAH rather than by height alone
+    template <class T>
+    class aabb_tree {
+    public:
+        using box_type = object::aabb3d<T>;
+        using vector_type = object::vector3d<T>;
+        using proxy_type = std::int32_t;
+        using value_type = std::uint32_t;
+
+        static constexpr proxy_type null_proxy = -1;
+
+        explicit aabb_tree(T margin = 0) noexcept;
+
+        proxy_type insert(const box_type& box, value_type value);
+        void erase(proxy_type proxy);
+
+        bool move(proxy_type proxy, const box_type& box, const vector_type& displacement);
+        void refit(proxy_type proxy, const box_type& box);
+
+        const box_type& bounds(proxy_type proxy) const;
+        value_type value(proxy_type proxy) const;
+
+        template <class F>
+        void query(const box_type& region, F callback) const;
+        std::vector<value_type> query(const box_type& region) const;
+
+        template <class F>
+        void raycast(const vector_type& origin, const vector_type& direction, T max_distance, F callback) const;
+        std::optional<std::pair<value_type, T>> raycast(const vector_type& origin, const vector_type& direction, T max_distance) const;
+
+        std::optional<std::pair<value_type, T>> nearest(const vector_type& point) const;
+
+        size_t size() const;
+        size_t height() const;
+
+    private:
+        struct node {
+            box_type box; // fat, what the tree is built and moved by
+            box_type tight; // the box as given, what leaves are tested by
+            proxy_type parent; // next free node while released
+            proxy_type children[2];
+            std::int32_t height; // 0 for leaves, -1 while released
+            value_type value;
+        };
+
+        proxy_type allocate();
+        void release(proxy_type index);
+
+        void insert_leaf(proxy_type leaf);
+        void remove_leaf(proxy_type leaf);
+
+        void refit_ancestors(proxy_type index, bool rotate);
+        void rotate(proxy_type index);
+
+        static T distance_squared(const box_type& box, const vector_type& point);
+        static bool ray_entry(const box_type& box, const vector_type& origin, const vector_type& inverse, T max_distance, T& entry);
+
+        std::vector<node> nodes;
+        proxy_type root = null_proxy;
+        proxy_type free_list = null_proxy;
+        size_t leaf_count = 0;
+
+        T margin;
+    };
+
+    template <class T>
+    aabb_tree<T>::aabb_tree(T margin) noexcept
+        : margin(margin) {}
+
+    template <class T>
+    typename aabb_tree<T>::proxy_type aabb_tree<T>::insert(const box_type& box, value_type value) {
+        const proxy_type leaf = allocate();
+
+        nodes[leaf].box = box.expanded(margin);
+        nodes[leaf].tight = box;
+        nodes[leaf].value = value;
+        nodes[leaf].height = 0;
+
+        insert_leaf(leaf);
+        leaf_count++;
+
+        return leaf;
+    }
+
+    template <class T>
+    void aabb_tree<T>::erase(proxy_type proxy) {
+        remove_leaf(proxy);
+        release(proxy);
+        leaf_count--;
+    }
+
+    // a leaf is only reinserted once its box leaves the fat box, which is stretched
+    // along the displacement so steady movement stays inside it for a while
+    template <class T>
+    bool aabb_tree<T>::move(proxy_type proxy, const box_type& box, const vector_type& displacement) {
+        nodes[proxy].tight = box;
+
+        if (nodes[proxy].box.contains(box))
+            return false;
+
+        remove_leaf(proxy);
+
+        const box_type fat = box.expanded(margin);
+        vector_type lower = fat.lower(), upper = fat.upper();
+
+        for (size_t axis = 0; axis < 3; axis++)
+            (displacement[axis] < 0 ? lower[axis] : upper[axis]) += 4 * displacement[axis];
+
+        nodes[proxy].box = box_type(lower, upper);
+        insert_leaf(proxy);
+
+        return true;
+    }
+
+    // replaces the box in place, cheaper than move when the tree shape may stay as it is
+    template <class T>
+    void aabb_tree<T>::refit(proxy_type proxy, const box_type& box) {
+        nodes[proxy].box = box.expanded(margin);
+        nodes[proxy].tight = box;
+        refit_ancestors(nodes[proxy].parent, false);
+    }
+
+    template <class T>
+    const typename aabb_tree<T>::box_type& aabb_tree<T>::bounds(proxy_type proxy) const {
+        return nodes[proxy].box;
+    }
+
+    template <class T>
+    typename aabb_tree<T>::value_type aabb_tree<T>::value(proxy_type proxy) const {
+        return nodes[proxy].value;
+    }
+
+    // callback(value) for every box overlapping region, returning false stops the query
+    template <class T>
+    template <class F>
+    void aabb_tree<T>::query(const box_type& region, F callback) const {
+        std::vector<proxy_type> stack;
+        stack.reserve(64);
+
+        if (root != null_proxy)
+            stack.push_back(root);
+
+        while (!stack.empty()) {
+            const node& current = nodes[stack.back()];
+            stack.pop_back();
+
+            if (!(current.height == 0 ? current.tight : current.box).check_bounds(region))
+                continue;
+
+            if (current.height == 0) {
+                if (!callback(current.value))
+                    return;
+            } else {
+                stack.push_back(current.children[0]);
+                stack.push_back(current.children[1]);
+            }
+        }
+    }
+
+    template <class T>
+    std::vector<typename aabb_tree<T>::value_type> aabb_tree<T>::query(const box_type& region) const {
+        std::vector<value_type> result;
+
+        query(region, [&](value_type value) {
+            result.push_back(value);
+            return true;
+        });
+        return result;
+    }
+
+    // callback(value, entry) for boxes hit within max_distance, nearer subtrees first,
+    // it returns the new max_distance, so returning entry keeps only nearer hits and 0 stops
+    template <class T>
+    template <class F>
+    void aabb_tree<T>::raycast(const vector_type& origin, const vector_type& direction, T max_distance, F callback) const {
+        const vector_type inverse(1 / direction[0], 1 / direction[1], 1 / direction[2]);
+
+        std::vector<proxy_type> stack;
+        stack.reserve(64);
+
+        if (root != null_proxy)
+            stack.push_back(root);
+
+        while (!stack.empty()) {
+            const node& current = nodes[stack.back()];
+            stack.pop_back();
+
+            T entry;
+            if (!ray_entry(current.height == 0 ? current.tight : current.box, origin, inverse, max_distance, entry))
+                continue;
+
+            if (current.height == 0) {
+                max_distance = callback(current.value, entry);
+                if (max_distance <= 0)
+                    return;
+                continue;
+            }
+
+            T entries[2];
+            bool hits[2];
+
+            for (size_t i = 0; i < 2; i++)
+                hits[i] = ray_entry(nodes[current.children[i]].box, origin, inverse, max_distance, entries[i]);
+
+            const size_t nearer = hits[1] && (!hits[0] || entries[1] < entries[0]);
+
+            if (hits[1 - nearer])
+                stack.push_back(current.children[1 - nearer]);
+            if (hits[nearer])
+                stack.push_back(current.children[nearer]);
+        }
+    }
+
+    template <class T>
+    std::optional<std::pair<typename aabb_tree<T>::value_type, T>>
+    aabb_tree<T>::raycast(const vector_type& origin, const vector_type& direction, T max_distance) const {
+        std::optional<std::pair<value_type, T>> hit;
+
+        raycast(origin, direction, max_distance, [&](value_type value, T entry) {
+            hit.emplace(value, entry);
+            return entry;
+        });
+        return hit;
+    }
+
+    // fat boxes only bound the distance from below for pruning, leaves are measured to their own box
+    template <class T>
+    std::optional<std::pair<typename aabb_tree<T>::value_type, T>> aabb_tree<T>::nearest(const vector_type& point) const {
+        std::optional<std::pair<value_type, T>> best;
+        T best_distance = std::numeric_limits<T>::max();
+
+        std::vector<std::pair<proxy_type, T>> stack;
+        stack.reserve(64);
+
+        if (root != null_proxy)
+            stack.emplace_back(root, distance_squared(nodes[root].box, point));
+
+        while (!stack.empty()) {
+            auto [index, distance] = stack.back();
+            stack.pop_back();
+
+            if (distance >= best_distance)
+                continue;
+
+            const node& current = nodes[index];
+
+            if (current.height == 0) {
+                const T leaf_distance = distance_squared(current.tight, point);
+
+                if (leaf_distance < best_distance) {
+                    best_distance = leaf_distance;
+                    best.emplace(current.value, leaf_distance);
+                }
+                continue;
+            }
+
+            const T first = distance_squared(nodes[current.children[0]].box, point);
+            const T second = distance_squared(nodes[current.children[1]].box, point);
+
+            if (first < second) {
+                stack.emplace_back(current.children[1], second);
+                stack.emplace_back(current.children[0], first);
+            } else {
+                stack.emplace_back(current.children[0], first);
+                stack.emplace_back(current.children[1], second);
+            }
+        }
+
+        if (best)
+            best->second = std::sqrt(best->second);
+        return best;
+    }
+
+    template <class T>
+    size_t aabb_tree<T>::size() const {
+        return leaf_count;
+    }
+
+    template <class T>
+    size_t aabb_tree<T>::height() const {
+        return root == null_proxy ? 0 : static_cast<size_t>(nodes[root].height);
+    }
+
+    template <class T>
+    typename aabb_tree<T>::proxy_type aabb_tree<T>::allocate() {
+        proxy_type index;
+
+        if (free_list == null_proxy) {
+            index = static_cast<proxy_type>(nodes.size());
+            nodes.emplace_back();
+        } else {
+            index = free_list;
+            free_list = nodes[index].parent;
+        }
+
+        nodes[index].parent = null_proxy;
+        nodes[index].children[0] = nodes[index].children[1] = null_proxy;
+        nodes[index].height = 0;
+
+        return index;
+    }
+
+    template <class T>
+    void aabb_tree<T>::release(proxy_type index) {
+        nodes[index].parent = free_list;
+        nodes[index].height = -1;
+        free_list = index;
+    }
+
+    template <class T>
+    void aabb_tree<T>::insert_leaf(proxy_type leaf) {
+        if (root == null_proxy) {
+            root = leaf;
+            nodes[root].parent = null_proxy;
+            return;
+        }
+
+        const box_type box = nodes[leaf].box;
+        proxy_type index = root;
+
+        // stop where pairing with the current node is cheaper than pushing the box further down
+        while (nodes[index].height > 0) {
+            const node& current = nodes[index];
+
+            const T area = current.box.area();
+            const T combined = current.box.merged(box).area();
+
+            const T cost = 2 * combined;
+            const T inheritance = 2 * (combined - area);
+
+            T child_costs[2];
+            for (size_t i = 0; i < 2; i++) {
+                const node& child = nodes[current.children[i]];
+                const T merged = child.box.merged(box).area();
+
+                child_costs[i] = (child.height == 0 ? merged : merged - child.box.area()) + inheritance;
+            }
+
+            if (cost < child_costs[0] && cost < child_costs[1])
+                break;
+
+            index = current.children[child_costs[1] < child_costs[0]];
+        }
+
+        const proxy_type sibling = index;
+        const proxy_type old_parent = nodes[sibling].parent;
+        const proxy_type new_parent = allocate();
+
+        nodes[new_parent].parent = old_parent;
+        nodes[new_parent].box = box.merged(nodes[sibling].box);
+        nodes[new_parent].height = nodes[sibling].height + 1;
+        nodes[new_parent].children[0] = sibling;
+        nodes[new_parent].children[1] = leaf;
+
+        if (old_parent == null_proxy)
+            root = new_parent;
+        else
+            nodes[old_parent].children[nodes[old_parent].children[1] == sibling] = new_parent;
+
+        nodes[sibling].parent = new_parent;
+        nodes[leaf].parent = new_parent;
+
+        refit_ancestors(new_parent, true);
+    }
+
+    template <class T>
+    void aabb_tree<T>::remove_leaf(proxy_type leaf) {
+        if (leaf == root) {
+            root = null_proxy;
+            return;
+        }
+
+        const proxy_type parent = nodes[leaf].parent;
+        const proxy_type grandparent = nodes[parent].parent;
+        const proxy_type sibling = nodes[parent].children[nodes[parent].children[0] == leaf];
+
+        nodes[sibling].parent = grandparent;
+        release(parent);
+
+        if (grandparent == null_proxy) {
+            root = sibling;
+            return;
+        }
+
+        nodes[grandparent].children[nodes[grandparent].children[1] == parent] = sibling;
+        refit_ancestors(grandparent, true);
+    }
+
+    template <class T>
+    void aabb_tree<T>::refit_ancestors(proxy_type index, bool rotate) {
+        for (; index != null_proxy; index = nodes[index].parent) {
+            if (rotate)
+                this->rotate(index);
+
+            node& current = nodes[index];
+            const node& first = nodes[current.children[0]];
+            const node& second = nodes[current.children[1]];
+
+            current.box = first.box.merged(second.box);
+            current.height = 1 + std::max(first.height, second.height);
+        }
+    }
+
+    // swaps one child of index with a grandchild under its other child when that shrinks the other child
+    template <class T>
+    void aabb_tree<T>::rotate(proxy_type index) {
+        if (nodes[index].height < 2)
+            return;
+
+        T best_cost = 0;
+        proxy_type best_child = null_proxy, best_grandchild = null_proxy;
+
+        for (size_t i = 0; i < 2; i++) {
+            const proxy_type child = nodes[index].children[i];
+            const proxy_type other = nodes[index].children[1 - i];
+
+            if (nodes[other].height == 0)
+                continue;
+
+            const T area = nodes[other].box.area();
+
+            for (size_t j = 0; j < 2; j++) {
+                const proxy_type grandchild = nodes[other].children[j];
+                const proxy_type remaining = nodes[other].children[1 - j];
+
+                const T cost = nodes[child].box.merged(nodes[remaining].box).area() - area;
+
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_child = child;
+                    best_grandchild = grandchild;
+                }
+            }
+        }
+
+        if (best_child == null_proxy)
+            return;
+
+        const proxy_type other = nodes[best_grandchild].parent;
+        node& current = nodes[index];
+        node& swapped = nodes[other];
+
+        current.children[current.children[1] == best_child] = best_grandchild;
+        swapped.children[swapped.children[1] == best_grandchild] = best_child;
+
+        nodes[best_grandchild].parent = index;
+        nodes[best_child].parent = other;
+
+        const node& first = nodes[swapped.children[0]];
+        const node& second = nodes[swapped.children[1]];
+
+        swapped.box = first.box.merged(second.box);
+        swapped.height = 1 + std::max(first.height, second.height);
+    }
+
+    template <class T>
+    T aabb_tree<T>::distance_squared(const box_type& box, const vector_type& point) {
+        T distance = 0;
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            const T gap = std::max({box.lower(axis) - point[axis], point[axis] - box.upper(axis), T(0)});
+            distance += gap * gap;
+        }
+        return distance;
+    }
+
+    // slab test, entry is clamped to 0 when the origin is inside the box
+    template <class T>
+    bool aabb_tree<T>::ray_entry(const box_type& box, const vector_type& origin, const vector_type& inverse, T max_distance, T& entry) {
+        T near = 0, far = max_distance;
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            T first = (box.lower(axis) - origin[axis]) * inverse[axis];
+            T second = (box.upper(axis) - origin[axis]) * inverse[axis];
+
+            if (first > second)
+                std::swap(first, second);
+
+            near = std::max(near, first);
+            far = std::min(far, second);
+        }
+
+        entry = near;
+        return near <= far;
+    }
+
+    // entities as dense parallel arrays of components, every system pass walks the arrays it reads
+    // front to back instead of visiting one heap object after another, erasing swaps the last entity
+    // into the gap so the arrays stay dense, ids map onto dense slots through a sparse table
+    template <class T>
+    class entity_store {
+    public:
+        using entity_type = std::uint32_t;
+        using vector_type = object::vector3d<T>;
+        using quaternion_type = object::quaternion<T>;
+        using pose_type = object::affine3d<T>;
+        using box_type = object::aabb3d<T>;
+        using mesh_type = object::shared_mesh3d<T>;
+        using sequence_type = object::sequence3d<T>;
+        using buffer_type = object::vertex_buffer3d<T>;
+
+        entity_type create(const mesh_type& mesh, const vector_type& translation, const vector_type& rotation);
+        entity_type create(const object::dynamic_object3d<T>& object);
+        void erase(entity_type entity);
+
+        bool contains(entity_type entity) const;
+        size_t size() const;
+
+        void assign(entity_type entity, sequence_type sequence);
+        bool moving(entity_type entity) const;
+
+        const vector_type& translation(entity_type entity) const;
+        const quaternion_type& orientation(entity_type entity) const;
+        const pose_type& pose(entity_type entity) const;
+        const box_type& bounds(entity_type entity) const;
+        const mesh_type& mesh(entity_type entity) const;
+
+        size_t integrate();
+        void update_bounds();
+
+        template <class F>
+        void collide(F callback);
+
+        void emit(buffer_type& destination, std::vector<size_t>& offsets) const;
+
+    private:
+        static constexpr entity_type null_slot = std::numeric_limits<entity_type>::max();
+
+        void start(size_t slot);
+
+        // dense, one entry per live entity
+        std::vector<entity_type> entities;
+        std::vector<vector_type> translations;
+        std::vector<vector_type> rotations;
+        std::vector<quaternion_type> orientations;
+        std::vector<pose_type> poses;
+        std::vector<box_type> boxes;
+        std::vector<mesh_type> meshes;
+
+        // the sequence under way and the pose it started from
+        std::vector<std::optional<sequence_type>> sequences;
+        std::vector<object::step3d<T>> starts;
+        std::vector<quaternion_type> start_orientations;
+        std::vector<quaternion_type> stop_orientations;
+
+        // sparse, by entity
+        std::vector<entity_type> slots;
+        std::vector<entity_type> free_entities;
+
+        // slots by lower x bound, kept between collide passes, where it is nearly sorted already
+        std::vector<entity_type> sweep_order;
+    };
+
+    template <class T>
+    typename entity_store<T>::entity_type entity_store<T>::create(const mesh_type& mesh, const vector_type& translation,
+                                                                  const vector_type& rotation) {
+        entity_type entity;
+
+        if (free_entities.empty()) {
+            entity = static_cast<entity_type>(slots.size());
+            slots.push_back(null_slot);
+        } else {
+            entity = free_entities.back();
+            free_entities.pop_back();
+        }
+
+        const auto slot = static_cast<entity_type>(entities.size());
+        slots[entity] = slot;
+
+        entities.push_back(entity);
+        translations.push_back(translation);
+        rotations.push_back(rotation);
+        orientations.push_back(quaternion_type::rotation_degrees(rotation));
+        poses.emplace_back();
+        boxes.emplace_back();
+        meshes.push_back(mesh);
+
+        sequences.emplace_back();
+        starts.emplace_back();
+        start_orientations.emplace_back();
+        stop_orientations.emplace_back();
+
+        sweep_order.push_back(slot);
+        return entity;
+    }
+
+    template <class T>
+    typename entity_store<T>::entity_type entity_store<T>::create(const object::dynamic_object3d<T>& object) {
+        const entity_type entity = create(object.mesh(), object.translation(), object.rotation());
+
+        orientations[slots[entity]] = object.orientation();
+        return entity;
+    }
+
+    template <class T>
+    void entity_store<T>::erase(entity_type entity) {
+        const entity_type slot = slots[entity];
+        const entity_type last = static_cast<entity_type>(entities.size() - 1);
+
+        auto remove = [&](auto& components) {
+            components[slot] = std::move(components[last]);
+            components.pop_back();
+        };
+
+        remove(entities);
+        remove(translations);
+        remove(rotations);
+        remove(orientations);
+        remove(poses);
+        remove(boxes);
+        remove(meshes);
+        remove(starts);
+        remove(start_orientations);
+        remove(stop_orientations);
+
+        // sequences keep their substep counts const, so they are rebuilt in place rather than assigned
+        if (slot != last && sequences[last])
+            sequences[slot].emplace(std::move(*sequences[last]));
+        else if (slot != last)
+            sequences[slot].reset();
+        sequences.pop_back();
+
+        if (slot != last)
+            slots[entities[slot]] = slot;
+        slots[entity] = null_slot;
+        free_entities.push_back(entity);
+
+        sweep_order.erase(std::find(sweep_order.begin(), sweep_order.end(), slot));
+        if (slot != last)
+            *std::find(sweep_order.begin(), sweep_order.end(), last) = slot;
+    }
+
+    template <class T>
+    bool entity_store<T>::contains(entity_type entity) const {
+        return entity < slots.size() && slots[entity] != null_slot;
+    }
+
+    template <class T>
+    size_t entity_store<T>::size() const {
+        return entities.size();
+    }
+
+    // replaces the sequence under way, it starts from wherever the entity is now
+    template <class T>
+    void entity_store<T>::assign(entity_type entity, sequence_type sequence) {
+        const entity_type slot = slots[entity];
+
+        sequences[slot].emplace(std::move(sequence));
+        start(slot);
+    }
+
+    template <class T>
+    bool entity_store<T>::moving(entity_type entity) const {
+        return sequences[slots[entity]].has_value();
+    }
+
+    template <class T>
+    const typename entity_store<T>::vector_type& entity_store<T>::translation(entity_type entity) const {
+        return translations[slots[entity]];
+    }
+
+    template <class T>
+    const typename entity_store<T>::quaternion_type& entity_store<T>::orientation(entity_type entity) const {
+        return orientations[slots[entity]];
+    }
+
+    template <class T>
+    const typename entity_store<T>::pose_type& entity_store<T>::pose(entity_type entity) const {
+        return poses[slots[entity]];
+    }
+
+    template <class T>
+    const typename entity_store<T>::box_type& entity_store<T>::bounds(entity_type entity) const {
+        return boxes[slots[entity]];
+    }
+
+    template <class T>
+    const typename entity_store<T>::mesh_type& entity_store<T>::mesh(entity_type entity) const {
+        return meshes[slots[entity]];
+    }
+
+    // one substep of every sequence under way, with the same paths as object3d, finished sequences
+    // land exactly on their step and are dropped, returns how many are still under way
+    template <class T>
+    size_t entity_store<T>::integrate() {
+        size_t under_way = 0;
+
+        for (size_t i = 0; i < entities.size(); i++) {
+            if (!sequences[i])
+                continue;
+
+            sequence_type& sequence = *sequences[i];
+            auto [stage, substep] = sequence.next_substep();
+
+            if (stage == object::STOP) {
+                translations[i] = vector_type(starts[i].translation() + substep.translation());
+                rotations[i] = vector_type(starts[i].rotation() + substep.rotation());
+                orientations[i] = quaternion_type::rotation_degrees(rotations[i]);
+
+                sequences[i].reset();
+                continue;
+            }
+
+            translations[i] += substep.translation();
+            rotations[i] += substep.rotation();
+
+            if (sequence.interpolation() == object::EULER)
+                orientations[i] = quaternion_type::rotation_degrees(rotations[i]);
+            else
+                orientations[i] = quaternion_type::slerp(start_orientations[i], stop_orientations[i], sequence.progress());
+
+            under_way++;
+        }
+        return under_way;
+    }
+
+    template <class T>
+    void entity_store<T>::update_bounds() {
+        for (size_t i = 0; i < entities.size(); i++) {
+            poses[i] = pose_type::translating(translations[i]) * pose_type::rotating(orientations[i], meshes[i]->origin());
+            boxes[i] = meshes[i]->bounds().transformed(poses[i]);
+        }
+    }
+
+    // sweep and prune along x, callback(first, second) once per pair of overlapping bounds,
+    // the order is insertion sorted from the last pass, which is close to linear while entities move little
+    template <class T>
+    template <class F>
+    void entity_store<T>::collide(F callback) {
+        for (size_t i = 1; i < sweep_order.size(); i++) {
+            const entity_type slot = sweep_order[i];
+            const T lower = boxes[slot].lower(0);
+
+            size_t j = i;
+            for (; j > 0 && boxes[sweep_order[j - 1]].lower(0) > lower; j--)
+                sweep_order[j] = sweep_order[j - 1];
+            sweep_order[j] = slot;
+        }
+
+        for (size_t i = 0; i < sweep_order.size(); i++) {
+            const box_type& first = boxes[sweep_order[i]];
+
+            for (size_t j = i + 1; j < sweep_order.size(); j++) {
+                const box_type& second = boxes[sweep_order[j]];
+                if (second.lower(0) > first.upper(0))
+                    break;
+
+                if (first.check_bounds(second))
+                    callback(entities[sweep_order[i]], entities[sweep_order[j]]);
+            }
+        }
+    }
+
+    // every entity's vertexes under its pose into one buffer, entity at slot i starts at offsets[i]
+    template <class T>
+    void entity_store<T>::emit(buffer_type& destination, std::vector<size_t>& offsets) const {
+        offsets.resize(entities.size() + 1);
+        offsets[0] = 0;
+
+        for (size_t i = 0; i < entities.size(); i++)
+            offsets[i + 1] = offsets[i] + meshes[i]->vertexes().size();
+        destination.resize(offsets.back());
+
+        for (size_t i = 0; i < entities.size(); i++)
+            poses[i].apply(meshes[i]->vertexes(), destination, offsets[i]);
+    }
+
+    template <class T>
+    void entity_store<T>::start(size_t slot) {
+        const object::step3d<T>& step = sequences[slot]->next_step();
+
+        starts[slot] = object::step3d<T>(translations[slot], rotations[slot]);
+        start_orientations[slot] = orientations[slot];
+        stop_orientations[slot] = quaternion_type::rotation_degrees(vector_type(rotations[slot] + step.rotation()));
+    }
 }
 
 #endif //DRONE_SCENES_HPP
@@ -2,8 +2,13 @@
 #define DRONE_TRANSFORMS_HPP
 
 #include <iostream>
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <cmath>
 
-#include "../include/geometry.hpp"
+#include "../inc/object.hpp"
 
 namespace drone::transforms {
 
@@ -63,6 +68,237 @@ namespace drone::transforms {
 
     template <class T>
     using transform3d = basic_transform<geometry::vector3d<T>>;
+
+    // parent relative poses with cached local to world ones, based on: Gregory, "Game Engine Architecture",
+    // nodes are stored parents first, so update is one forward pass where a node is recomputed
+    // only when it or one of its ancestors was moved since the last update
+    template <class T>
+    class transform_hierarchy {
+    public:
+        using node_type = std::uint32_t;
+        using vector_type = object::vector3d<T>;
+        using quaternion_type = object::quaternion<T>;
+        using pose_type = object::affine3d<T>;
+
+        static constexpr node_type null_node = std::numeric_limits<node_type>::max();
+
+        node_type insert(node_type parent, const pose_type& local);
+        node_type insert(node_type parent, const vector_type& translation, const quaternion_type& orientation);
+
+        void place(node_type node, const pose_type& local);
+        void place(node_type node, const vector_type& translation, const quaternion_type& orientation);
+        void transform(node_type node, const pose_type& transform);
+
+        node_type parent(node_type node) const;
+        const pose_type& local(node_type node) const;
+        const pose_type& world(node_type node) const;
+
+        size_t update();
+
+        size_t size() const;
+        void reserve(size_t size);
+
+    private:
+        std::vector<node_type> parents;
+        std::vector<pose_type> locals;
+        std::vector<pose_type> worlds;
+
+        // set by place and transform, spread to descendants and cleared by update
+        std::vector<unsigned char> dirty;
+        bool changed = false;
+    };
+
+    // the parent must already be in the hierarchy, null_node for a root
+    template <class T>
+    typename transform_hierarchy<T>::node_type transform_hierarchy<T>::insert(node_type parent, const pose_type& local) {
+        const auto node = static_cast<node_type>(parents.size());
+
+        parents.push_back(parent);
+        locals.push_back(local);
+        worlds.push_back(local);
+        dirty.push_back(1);
+
+        changed = true;
+        return node;
+    }
+
+    template <class T>
+    typename transform_hierarchy<T>::node_type transform_hierarchy<T>::insert(node_type parent, const vector_type& translation,
+                                                                              const quaternion_type& orientation) {
+        return insert(parent, pose_type(orientation.matrix(), translation));
+    }
+
+    template <class T>
+    void transform_hierarchy<T>::place(node_type node, const pose_type& local) {
+        locals[node] = local;
+        dirty[node] = 1;
+        changed = true;
+    }
+
+    template <class T>
+    void transform_hierarchy<T>::place(node_type node, const vector_type& translation, const quaternion_type& orientation) {
+        place(node, pose_type(orientation.matrix(), translation));
+    }
+
+    // applied after the current local pose, in the parent's frame
+    template <class T>
+    void transform_hierarchy<T>::transform(node_type node, const pose_type& transform) {
+        place(node, transform * locals[node]);
+    }
+
+    template <class T>
+    typename transform_hierarchy<T>::node_type transform_hierarchy<T>::parent(node_type node) const {
+        return parents[node];
+    }
+
+    template <class T>
+    const typename transform_hierarchy<T>::pose_type& transform_hierarchy<T>::local(node_type node) const {
+        return locals[node];
+    }
+
+    // as of the last update
+    template <class T>
+    const typename transform_hierarchy<T>::pose_type& transform_hierarchy<T>::world(node_type node) const {
+        return worlds[node];
+    }
+
+    // returns how many world poses were recomputed
+    template <class T>
+    size_t transform_hierarchy<T>::update() {
+        if (!changed)
+            return 0;
+
+        size_t recomputed = 0;
+
+        for (size_t i = 0; i < parents.size(); i++) {
+            const node_type parent = parents[i];
+
+            if (parent != null_node)
+                dirty[i] |= dirty[parent];
+            if (!dirty[i])
+                continue;
+
+            worlds[i] = parent == null_node ? locals[i] : worlds[parent] * locals[i];
+            recomputed++;
+        }
+
+        std::fill(dirty.begin(), dirty.end(), 0);
+        changed = false;
+        return recomputed;
+    }
+
+    template <class T>
+    size_t transform_hierarchy<T>::size() const {
+        return parents.size();
+    }
+
+    template <class T>
+    void transform_hierarchy<T>::reserve(size_t size) {
+        parents.reserve(size);
+        locals.reserve(size);
+        worlds.reserve(size);
+        dirty.reserve(size);
+    }
+
+    // copies of one part mesh, each mounted on a hierarchy node and spun by one of a few shared tracks,
+    // a track rotates the cached part vertexes once per tick and every instance on it only places that copy,
+    // so the spin costs one matrix and one vertex pass per track instead of per instance
+    template <class T>
+    class part_instances {
+    public:
+        using node_type = typename transform_hierarchy<T>::node_type;
+        using track_type = std::uint32_t;
+        using vector_type = object::vector3d<T>;
+        using pose_type = object::affine3d<T>;
+        using mesh_type = object::shared_mesh3d<T>;
+        using buffer_type = object::vertex_buffer3d<T>;
+
+        part_instances() = delete;
+        explicit part_instances(const mesh_type& part);
+
+        track_type add_track(const vector_type& axis, T degrees_per_tick);
+        void add(node_type mount, track_type track);
+
+        void advance(T ticks = 1);
+
+        pose_type pose(const transform_hierarchy<T>& hierarchy, size_t instance) const;
+        void emit(const transform_hierarchy<T>& hierarchy, buffer_type& destination) const;
+
+        size_t size() const;
+
+    private:
+        struct track {
+            vector_type axis;
+            T rate;
+            T angle;
+
+            pose_type spin;
+            buffer_type vertexes;
+        };
+
+        void spin(track& track);
+
+        mesh_type part;
+
+        std::vector<track> tracks;
+        std::vector<node_type> mounts;
+        std::vector<track_type> instance_tracks;
+    };
+
+    template <class T>
+    part_instances<T>::part_instances(const mesh_type& part)
+        : part(part) {}
+
+    // spins right handed about axis through the part mesh origin, as quaternion::axis_degrees does,
+    // the euler rotations of dynamic_object3d turn the other way
+    template <class T>
+    typename part_instances<T>::track_type part_instances<T>::add_track(const vector_type& axis, T degrees_per_tick) {
+        tracks.push_back({axis, degrees_per_tick, 0, pose_type::identity(), buffer_type()});
+        spin(tracks.back());
+
+        return static_cast<track_type>(tracks.size() - 1);
+    }
+
+    template <class T>
+    void part_instances<T>::add(node_type mount, track_type track) {
+        mounts.push_back(mount);
+        instance_tracks.push_back(track);
+    }
+
+    template <class T>
+    void part_instances<T>::advance(T ticks) {
+        for (track& track : tracks) {
+            track.angle = std::fmod(track.angle + track.rate * ticks, T(360));
+            spin(track);
+        }
+    }
+
+    // the mount's world pose as of its hierarchy's last update, then the spin
+    template <class T>
+    typename part_instances<T>::pose_type part_instances<T>::pose(const transform_hierarchy<T>& hierarchy, size_t instance) const {
+        return hierarchy.world(mounts[instance]) * tracks[instance_tracks[instance]].spin;
+    }
+
+    // instance i into vertexes [i * part size, (i + 1) * part size)
+    template <class T>
+    void part_instances<T>::emit(const transform_hierarchy<T>& hierarchy, buffer_type& destination) const {
+        const size_t count = part->vertexes().size();
+        destination.resize(mounts.size() * count);
+
+        for (size_t i = 0; i < mounts.size(); i++)
+            hierarchy.world(mounts[i]).apply(tracks[instance_tracks[i]].vertexes, destination, i * count);
+    }
+
+    template <class T>
+    size_t part_instances<T>::size() const {
+        return mounts.size();
+    }
+
+    template <class T>
+    void part_instances<T>::spin(track& track) {
+        track.spin = pose_type::rotating(object::quaternion<T>::axis_degrees(track.axis, track.angle), part->origin());
+        track.spin.apply(part->vertexes(), track.vertexes);
+    }
 }
 
 #endif //DRONE_TRANSFORMS_HPP
@@ -0,0 +1,235 @@
+#ifndef DRONE_WORKERS_HPP
+#define DRONE_WORKERS_HPP
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+
+namespace drone::workers {
+
+    // fixed set of threads sharing index ranges by work stealing, based on: Blumofe, Leiserson,
+    // "Scheduling multithreaded computations by work stealing" (1999), every worker splits the range
+    // at the back of its own queue in halves until it is no larger than the grain and runs that,
+    // idle workers take from the front of the others, where the largest ranges are left
+    class worker_pool {
+    public:
+        explicit worker_pool(size_t workers = std::thread::hardware_concurrency());
+        ~worker_pool();
+
+        worker_pool(const worker_pool&) = delete;
+        worker_pool& operator=(const worker_pool&) = delete;
+
+        size_t size() const;
+
+        template <class F>
+        void parallel_for(size_t count, size_t grain, F body);
+
+    private:
+        struct range {
+            size_t begin;
+            size_t end;
+        };
+
+        struct range_queue {
+            std::mutex mutex;
+            std::deque<range> ranges;
+        };
+
+        using job_type = void (*)(const void* body, size_t begin, size_t end);
+
+        template <class F>
+        static void invoke(const void* body, size_t begin, size_t end);
+
+        void run(job_type job, const void* body, size_t count, size_t grain);
+        void work(size_t worker);
+        bool work_once(size_t worker);
+
+        bool pop(size_t worker, range& taken);
+        bool steal(size_t worker, range& taken);
+        void split(size_t worker, range& taken);
+
+        std::vector<std::thread> threads;
+        std::vector<std::unique_ptr<range_queue>> queues;
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        size_t generation = 0;
+        bool stopping = false;
+
+        job_type job = nullptr;
+        const void* body = nullptr;
+        size_t grain = 1;
+
+        std::atomic<size_t> remaining{0};
+        std::exception_ptr failure;
+    };
+
+    // the calling thread is worker 0, so one worker spawns no threads and runs everything inline
+    inline worker_pool::worker_pool(size_t workers) {
+        workers = std::max<size_t>(workers, 1);
+
+        for (size_t i = 0; i < workers; i++)
+            queues.push_back(std::make_unique<range_queue>());
+
+        for (size_t i = 1; i < workers; i++)
+            threads.emplace_back(&worker_pool::work, this, i);
+    }
+
+    inline worker_pool::~worker_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    inline size_t worker_pool::size() const {
+        return queues.size();
+    }
+
+    // calls body(begin, end) over disjoint ranges covering [0, count) and returns once all ran,
+    // which ranges run on which thread varies, so body must only write what its indexes own
+    template <class F>
+    void worker_pool::parallel_for(size_t count, size_t grain, F body) {
+        if (count == 0)
+            return;
+
+        if (queues.size() == 1) {
+            body(size_t(0), count);
+            return;
+        }
+
+        run(&worker_pool::invoke<F>, &body, count, std::max<size_t>(grain, 1));
+    }
+
+    template <class F>
+    void worker_pool::invoke(const void* body, size_t begin, size_t end) {
+        (*static_cast<const F*>(body))(begin, end);
+    }
+
+    inline void worker_pool::run(job_type job, const void* body, size_t count, size_t grain) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->job = job;
+            this->body = body;
+            this->grain = grain;
+            failure = nullptr;
+            remaining.store(count, std::memory_order_relaxed);
+
+            // one contiguous share per worker, so a balanced load never has to be stolen
+            const size_t workers = queues.size();
+            for (size_t i = 0; i < workers; i++) {
+                range share{count * i / workers, count * (i + 1) / workers};
+
+                if (share.begin < share.end) {
+                    std::lock_guard<std::mutex> queue_lock(queues[i]->mutex);
+                    queues[i]->ranges.push_back(share);
+                }
+            }
+            generation++;
+        }
+        wake.notify_all();
+
+        while (remaining.load(std::memory_order_acquire) > 0)
+            if (!work_once(0))
+                std::this_thread::yield();
+
+        if (failure)
+            std::rethrow_exception(failure);
+    }
+
+    inline void worker_pool::work(size_t worker) {
+        size_t seen = 0;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+
+                if (stopping)
+                    return;
+                seen = generation;
+            }
+
+            while (remaining.load(std::memory_order_acquire) > 0)
+                if (!work_once(worker))
+                    std::this_thread::yield();
+        }
+    }
+
+    inline bool worker_pool::work_once(size_t worker) {
+        range taken;
+
+        if (!pop(worker, taken) && !steal(worker, taken))
+            return false;
+
+        split(worker, taken);
+
+        // a failed range still counts as done, the first failure is rethrown to the caller
+        try {
+            job(body, taken.begin, taken.end);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!failure)
+                failure = std::current_exception();
+        }
+
+        remaining.fetch_sub(taken.end - taken.begin, std::memory_order_acq_rel);
+        return true;
+    }
+
+    inline bool worker_pool::pop(size_t worker, range& taken) {
+        range_queue& queue = *queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.ranges.empty())
+            return false;
+
+        taken = queue.ranges.back();
+        queue.ranges.pop_back();
+        return true;
+    }
+
+    inline bool worker_pool::steal(size_t worker, range& taken) {
+        const size_t workers = queues.size();
+
+        for (size_t i = 1; i < workers; i++) {
+            range_queue& queue = *queues[(worker + i) % workers];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (queue.ranges.empty())
+                continue;
+
+            taken = queue.ranges.front();
+            queue.ranges.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    // keeps the first grain of the range and leaves the rest in halves, the larger ones nearer the front
+    inline void worker_pool::split(size_t worker, range& taken) {
+        if (taken.end - taken.begin <= grain)
+            return;
+
+        range_queue& queue = *queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        while (taken.end - taken.begin > grain) {
+            const size_t middle = taken.begin + (taken.end - taken.begin) / 2;
+            queue.ranges.push_back({middle, taken.end});
+            taken.end = middle;
+        }
+    }
+}
+
+#endif //DRONE_WORKERS_HPP
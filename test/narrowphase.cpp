@@ -0,0 +1,91 @@
+#include <iostream>
+#include <random>
+#include <cmath>
+
+#include "../include/collisions.hpp"
+
+using namespace object;
+
+using box_type = aabb3d<double>;
+using contact_type = drone::collisions::contact3d<double>;
+
+static vertex_buffer3d<double> corners(const box_type& box) {
+    vertex_buffer3d<double> vertexes;
+    for (size_t i = 0; i < 8; i++)
+        vertexes.push_back(vector3d<double>(i & 1 ? box.upper(0) : box.lower(0), i & 2 ? box.upper(1) : box.lower(1), i & 4 ? box.upper(2) : box.lower(2)));
+    return vertexes;
+}
+
+// per axis separation of two boxes, negative while they overlap along it
+static vector3d<double> gaps(const box_type& first, const box_type& second) {
+    vector3d<double> gap;
+    for (size_t axis = 0; axis < 3; axis++)
+        gap[axis] = std::max(second.lower(axis) - first.upper(axis), first.lower(axis) - second.upper(axis));
+    return gap;
+}
+
+// the exact distance of two boxes is the length of their positive gaps and their depth the smallest overlap,
+// second moved out along the reported normal by the reported depth has to end up touching first
+static double collide_error(const box_type& first, const box_type& second) {
+    const contact_type contact = drone::collisions::narrowphase<double>::collide(corners(first), corners(second));
+    const vector3d<double> gap = gaps(first, second);
+
+    double distance = 0, depth = std::numeric_limits<double>::max();
+    for (size_t axis = 0; axis < 3; axis++) {
+        distance += std::max(gap[axis], 0.0) * std::max(gap[axis], 0.0);
+        depth = std::min(depth, -gap[axis]);
+    }
+    distance = std::sqrt(distance);
+
+    const double unit = std::abs(std::sqrt(contact.normal * contact.normal) - 1);
+
+    if (depth <= 0 && !contact.intersecting)
+        return std::max(std::abs(contact.distance - distance), unit);
+    if (depth < 0)
+        return contact.depth - depth;
+
+    const vector3d<double> out(contact.normal * contact.depth);
+    const box_type moved(vector3d<double>(second.lower() + out), vector3d<double>(second.upper() + out));
+    const vector3d<double> left = gaps(first, moved);
+
+    return std::max({std::abs(contact.depth - depth), unit, std::abs(std::max({left[0], left[1], left[2]}))});
+}
+
+int main() {
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<double> place(-3, 3), extent(0.2, 2);
+
+    int failures = 0;
+    const auto check = [&failures](const char* name, const box_type& first, const box_type& second) {
+        const double error = collide_error(first, second);
+
+        if (!(error <= 1e-6)) {
+            std::cout << name << " boxes " << first.lower() << " " << first.upper() << " and " << second.lower() << " " << second.upper()
+                      << ": narrowphase error " << error << std::endl;
+            failures++;
+        }
+    };
+
+    std::vector<box_type> boxes;
+    for (size_t i = 0; i < 200; i++) {
+        const vector3d<double> center(place(generator), place(generator), place(generator));
+        const vector3d<double> half(extent(generator), extent(generator), extent(generator));
+        boxes.emplace_back(vector3d<double>(center - half), vector3d<double>(center + half));
+    }
+
+    for (size_t i = 0; i + 1 < boxes.size(); i++)
+        check("random", boxes[i], boxes[i + 1]);
+
+    for (const box_type& box : boxes) {
+        check("identical", box, box);
+
+        // touching along a face, an edge and a corner
+        for (size_t axes = 1; axes < 8; axes++) {
+            vector3d<double> offset;
+            for (size_t axis = 0; axis < 3; axis++)
+                offset[axis] = axes & (1 << axis) ? box.upper(axis) - box.lower(axis) : 0;
+            check("touching", box, box_type(vector3d<double>(box.lower() + offset), vector3d<double>(box.upper() + offset)));
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
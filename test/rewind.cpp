@@ -0,0 +1,101 @@
+#include <iostream>
+#include <random>
+#include <cmath>
+
+#include "../inc/object.hpp"
+
+using namespace object;
+
+// the poses met stepping straight through every sequence, one per substep from the first start
+template <class T>
+static std::vector<std::pair<vector3d<T>, quaternion<T>>> straight_poses(const std::vector<sequence3d<T>>& sequences, const shared_mesh3d<T>& mesh) {
+    object3d<T> straight(mesh);
+    for (const sequence3d<T>& sequence : sequences)
+        straight.next_sequence(sequence);
+
+    std::vector<std::pair<vector3d<T>, quaternion<T>>> poses{{straight.translation(), straight.orientation()}};
+    while (straight.next_substep())
+        poses.emplace_back(straight.translation(), straight.orientation());
+    poses.emplace_back(straight.translation(), straight.orientation());
+    return poses;
+}
+
+// random next_substep, previous_substep and rewind calls have to land where stepping straight there lands,
+// the substep reached is tracked together with how many sequences limit_history has dropped
+template <class T>
+static T rewind_error(const std::vector<sequence3d<T>>& sequences, size_t substeps, size_t limit, size_t interval,
+                      const shared_mesh3d<T>& mesh, std::mt19937& generator) {
+    const std::vector<std::pair<vector3d<T>, quaternion<T>>> poses = straight_poses(sequences, mesh);
+    const size_t total = sequences.size() * substeps;
+
+    object3d<T> scrubbed(mesh);
+    for (const sequence3d<T>& sequence : sequences)
+        scrubbed.next_sequence(sequence);
+    scrubbed.checkpoint_every(interval);
+    if (limit != 0)
+        scrubbed.limit_history(limit);
+
+    std::uniform_int_distribution<int> operation(0, 9);
+    size_t at = 0, dropped = 0;
+    T worst = 0;
+
+    for (size_t i = 0; i < 2000; i++) {
+        const int chosen = operation(generator);
+        bool stopped = false;
+
+        if (chosen < 5) {
+            scrubbed.next_substep();
+            stopped = at < total && (at + 1) % substeps == 0;
+            at = std::min(at + 1, total);
+        } else if (chosen < 9) {
+            scrubbed.previous_substep();
+            at = std::max(at, dropped * substeps + 1) - 1;
+        } else {
+            const size_t retained = sequences.size() - dropped;
+            const size_t sequence = std::uniform_int_distribution<size_t>(0, retained)(generator);
+            const size_t substep = std::uniform_int_distribution<size_t>(0, substeps + 1)(generator);
+
+            scrubbed.rewind(sequence, substep);
+            stopped = sequence < retained && substep >= substeps;
+            at = (dropped + sequence) * substeps + (sequence < retained ? std::min(substep, substeps) : 0);
+        }
+
+        // only a sequence finished by a substep drops the oldest beyond the limit, a rewind onto a start does not
+        if (limit != 0 && stopped && at / substeps > dropped + limit)
+            dropped = at / substeps - limit;
+
+        const vector3d<T> translation = poses[at].first - scrubbed.translation();
+        const T orientation = 1 - std::abs(poses[at].second.dot(scrubbed.orientation()));
+
+        worst = std::max({worst, std::sqrt(translation * translation), orientation});
+    }
+    return worst;
+}
+
+int main() {
+    const std::vector<vector3d<double>> vertexes{{0, 0, 0}, {1, 2, 3}};
+    const shared_mesh3d<double> mesh = std::make_shared<const mesh3d<double>>(vertexes);
+
+    std::mt19937 generator(5);
+    int failures = 0;
+
+    for (size_t substeps : {2, 3, 7}) {
+        std::vector<sequence3d<double>> sequences;
+        for (size_t j = 0; j < 24; j++)
+            sequences.emplace_back(step3d<double>(double(j % 5), -2, 0.5 * double(j % 3), 10 * double(j % 4), 0, 30),
+                                   substeps, rotation_interpolation(j % 3), substep_easing(j % 4));
+
+        for (size_t limit : {0, 1, 5}) {
+            for (size_t interval : {1, 3, 16}) {
+                const double error = rewind_error(sequences, substeps, limit, interval, mesh, generator);
+
+                if (error > 1e-9) {
+                    std::cout << "substeps " << substeps << " history " << limit << " checkpoints every " << interval
+                              << ": rewind error " << error << std::endl;
+                    failures++;
+                }
+            }
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <cmath>
+
+#include "../inc/object.hpp"
+
+using namespace object;
+
+// a sequence scrubbed back and forth has to land where stepping straight there lands,
+// it is queued twice so the scrubbing also crosses from one sequence into the next and back
+template <class T>
+static T scrub_error(const sequence3d<T>& sequence, const shared_mesh3d<T>& mesh) {
+    const size_t substeps = 2 * sequence.substeps();
+    T worst = 0;
+
+    for (size_t target = 0; target < substeps; target++) {
+        object3d<T> straight(mesh), scrubbed(mesh);
+        for (size_t i = 0; i < 2; i++) {
+            straight.next_sequence(sequence);
+            scrubbed.next_sequence(sequence);
+        }
+
+        for (size_t i = 0; i < target; i++)
+            straight.next_substep();
+
+        // overshoot, at most to the end, come back and wiggle
+        const size_t overshoot = std::min<size_t>(3, substeps - target);
+
+        for (size_t i = 0; i < target + overshoot; i++)
+            scrubbed.next_substep();
+        for (size_t i = 0; i < overshoot; i++)
+            scrubbed.previous_substep();
+        for (size_t i = 0; i < 4; i++) {
+            scrubbed.next_substep();
+            scrubbed.previous_substep();
+        }
+
+        const vector3d<T> translation = straight.translation() - scrubbed.translation();
+        const T orientation = 1 - std::abs(straight.orientation().dot(scrubbed.orientation()));
+
+        worst = std::max({worst, std::sqrt(translation * translation), orientation});
+    }
+    return worst;
+}
+
+int main() {
+    const std::vector<vector3d<double>> vertexes{{0, 0, 0}, {1, 2, 3}};
+    const shared_mesh3d<double> mesh = std::make_shared<const mesh3d<double>>(vertexes);
+
+    const step3d<double> step(10, -4, 2, 30, 0, 90);
+    const substep_interpolator3d<double> interpolators[] = {
+        linear_interpolator3d<double>(step),
+        hermite_interpolator3d<double>(step, step3d<double>(0, 5, 0, 0, 0, 0), step3d<double>(5, 0, 0, 0, 0, 0)),
+        catmull_rom_interpolator3d<double>(step3d<double>(0, 10, 0, 0, 0, 0), step, step3d<double>(10, 0, 0, 0, 0, 45))
+    };
+
+    int failures = 0;
+
+    for (const auto& interpolator : interpolators) {
+        for (int interpolation = EULER; interpolation <= INCREMENTAL; interpolation++) {
+            for (int easing = UNIFORM; easing <= EASE_IN_OUT; easing++) {
+                for (size_t substeps : {1, 2, 12}) {
+                    const sequence3d<double> sequence(interpolator, substeps, static_cast<rotation_interpolation>(interpolation),
+                                                      static_cast<substep_easing>(easing));
+                    const double error = scrub_error(sequence, mesh);
+
+                    if (error > 1e-9) {
+                        std::cout << "path " << interpolator.index() << " interpolation " << interpolation << " easing " << easing
+                                  << " substeps " << substeps << ": scrub error " << error << std::endl;
+                        failures++;
+                    }
+                }
+            }
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}